@@ -4,15 +4,27 @@
 		"sources": [
 			"src/callbacks.cc",
 			"src/openzwave.cc",
+			"src/openzwave-changes.cc",
 			"src/openzwave-config.cc",
 			"src/openzwave-driver.cc",
+			"src/openzwave-filters.cc",
 			"src/openzwave-groups.cc",
+			"src/openzwave-history.cc",
+			"src/openzwave-liveness.cc",
 			"src/openzwave-management.cc",
+			"src/openzwave-memory.cc",
+			"src/openzwave-meters.cc",
 			"src/openzwave-network.cc",
 			"src/openzwave-nodes.cc",
 			"src/openzwave-polling.cc",
+			"src/openzwave-profile.cc",
 			"src/openzwave-scenes.cc",
+			"src/openzwave-snapshot.cc",
+			"src/openzwave-strings.cc",
+			"src/openzwave-testing.cc",
 			"src/openzwave-values.cc",
+			"src/openzwave-valuetable.cc",
+			"src/openzwave-warmstart.cc",
 			"src/utils.cc",
 		],
 		"conditions": [
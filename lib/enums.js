@@ -56,3 +56,27 @@ var MetaDataFields;
 	MetaDataFields[MetaDataFields["Identifier"] = 13] = "Identifier";
 	MetaDataFields[MetaDataFields["Invalid"] = 255] = "Invalid";
 })(MetaDataFields = exports.MetaDataFields || (exports.MetaDataFields = {}));
+var ValueFields;
+(function (ValueFields) {
+	ValueFields[ValueFields["Id"] = 1] = "Id";
+	ValueFields[ValueFields["Metadata"] = 2] = "Metadata";
+	ValueFields[ValueFields["Value"] = 4] = "Value";
+	ValueFields[ValueFields["Items"] = 8] = "Items";
+	ValueFields[ValueFields["All"] = 15] = "All";
+})(ValueFields = exports.ValueFields || (exports.ValueFields = {}));
+var NodeFields;
+(function (NodeFields) {
+	NodeFields[NodeFields["Names"] = 1] = "Names";
+	NodeFields[NodeFields["Protocol"] = 2] = "Protocol";
+	NodeFields[NodeFields["Type"] = 4] = "Type";
+	NodeFields[NodeFields["Status"] = 8] = "Status";
+	NodeFields[NodeFields["All"] = 15] = "All";
+})(NodeFields = exports.NodeFields || (exports.NodeFields = {}));
+var NodeLiveness;
+(function (NodeLiveness) {
+	NodeLiveness[NodeLiveness["Unknown"] = 0] = "Unknown";
+	NodeLiveness[NodeLiveness["Alive"] = 1] = "Alive";
+	NodeLiveness[NodeLiveness["Awake"] = 2] = "Awake";
+	NodeLiveness[NodeLiveness["Asleep"] = 3] = "Asleep";
+	NodeLiveness[NodeLiveness["Dead"] = 4] = "Dead";
+})(NodeLiveness = exports.NodeLiveness || (exports.NodeLiveness = {}));
@@ -53,3 +53,27 @@ export enum MetaDataFields {
 	Identifier = 13,
 	Invalid = 255
 }
+
+export enum ValueFields {
+	Id = 1,
+	Metadata = 2,
+	Value = 4,
+	Items = 8,
+	All = 15
+}
+
+export enum NodeFields {
+	Names = 1,
+	Protocol = 2,
+	Type = 4,
+	Status = 8,
+	All = 15
+}
+
+export enum NodeLiveness {
+	Unknown = 0,
+	Alive = 1,
+	Awake = 2,
+	Asleep = 3,
+	Dead = 4
+}
@@ -38,7 +38,8 @@ mutex zqueue_mutex;
 
 // Node state.
 mutex znodes_mutex;
-::std::map<uint8_t, NodeInfo *> znodes;
+::std::atomic<NodeInfo *> znodes[NODE_SLOTS];
+::std::vector<ValueHandleSlot> zvalues;
 
 mutex zscenes_mutex;
 ::std::list<SceneInfo *> zscenes;
@@ -55,9 +56,18 @@ void ozw_watcher_callback(OpenZWave::Notification const *cb, void *ctx)
   notif->type = cb->GetType();
   notif->homeid = cb->GetHomeId();
   notif->nodeid = cb->GetNodeId();
+  notif->ts = nowMsec();
   // only valueId-related callbacks carry an actual OZW ValueID
+  notif->value.valid = false;
+  notif->meta.valid = false;
   if (notif->type <= OpenZWave::Notification::Type_ValueRefreshed) {
     notif->values.push_front(cb->GetValueID());
+    if (notif->type != OpenZWave::Notification::Type_ValueRemoved) {
+      captureValue(cb->GetValueID(), notif->value);
+    }
+    if (notif->type == OpenZWave::Notification::Type_ValueAdded) {
+      captureMetadata(cb->GetValueID(), notif->meta);
+    }
   }
   notif->help = getNotifHelpMsg(cb);
   /*
@@ -72,6 +82,11 @@ void ozw_watcher_callback(OpenZWave::Notification const *cb, void *ctx)
   case OpenZWave::Notification::Type_NodeEvent:
     notif->event = cb->GetEvent();
     break;
+  case OpenZWave::Notification::Type_PollingEnabled:
+  case OpenZWave::Notification::Type_PollingDisabled:
+    // the value whose polling got changed
+    notif->values.push_front(cb->GetValueID());
+    break;
   case OpenZWave::Notification::Type_CreateButton:
   case OpenZWave::Notification::Type_DeleteButton:
   case OpenZWave::Notification::Type_ButtonOn:
@@ -101,6 +116,7 @@ void ozw_watcher_callback(OpenZWave::Notification const *cb, void *ctx)
     break;
 #endif
   }
+  memory_count_notif(notif, true);
   // push the notification to the queue
   {
     mutex::scoped_lock sl(zqueue_mutex);
@@ -126,10 +142,12 @@ void ozw_ctrlcmd_callback(Driver::ControllerState _state,
   notif->event = _err;
   notif->notification = _state;
   notif->homeid = 0; // use as guard value for legacy mode
+  notif->ts = nowMsec();
   notif->help = ::std::string("Controller State: ")
                     .append(getControllerStateAsStr(_state))
                     .append(", Error: ")
                     .append(getControllerErrorAsStr(_err));
+  memory_count_notif(notif, true);
   {
     mutex::scoped_lock sl(zqueue_mutex);
     zqueue.push(notif);
@@ -168,17 +186,40 @@ void handleNotification(NotifInfo *notif)
 	//
   NodeInfo *node;
   //
+  liveness_record(notif);
   switch (notif->type) {
   //                            ################
   case OpenZWave::Notification::Type_ValueAdded: {
     //                            ################
     OpenZWave::ValueID value = notif->values.front();
-    Local<Object> valobj = zwaveValue2v8Value(value);
+    ValueInfo *vinfo = NULL;
 
     if ((node = get_node_info(notif->nodeid))) {
       mutex::scoped_lock sl(znodes_mutex);
-      node->values.push_back(value);
+      vinfo = find_stale_value(node, value);
+      if (vinfo) {
+        // loaded from the warm start file: keep its handle and slot
+        vinfo->stale = false;
+        vinfo->meta_cached = false;
+      } else {
+        node->values.push_back(ValueInfo(value));
+        vinfo = &node->values.back();
+        add_value_handle(vinfo);
+      }
+      if (notif->meta.valid) {
+        set_value_metadata(vinfo, notif->meta);
+      }
+      vinfo->cache = ::std::make_shared<CachedValue>(notif->value);
+      touch_value(vinfo);
+      if (vinfo->table_slot < 0) {
+        value_table_add(vinfo);
+      } else {
+        value_table_update(vinfo);
+      }
     }
+    Local<Object> valobj = zwaveValue2v8Value(value, ValueField_All, vinfo);
+    // after the metadata got cached, the units tell whether it's a counter
+    meter_record(vinfo, notif->ts);
 
     emitinfo[0] = Nan::New<String>("value added").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
@@ -191,10 +232,12 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_ValueRemoved: {
     //                            ##################
     OpenZWave::ValueID value = notif->values.front();
-    ::std::list<OpenZWave::ValueID>::iterator vit;
+    ::std::list<ValueInfo>::iterator vit;
     if ((node = get_node_info(notif->nodeid))) {
+      mutex::scoped_lock sl(znodes_mutex);
       for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
-        if ((*vit) == notif->values.front()) {
+        if (vit->id == value) {
+          release_value(&*vit);
           node->values.erase(vit);
           break;
         }
@@ -212,7 +255,20 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_ValueChanged: {
     //                            ##################
     OpenZWave::ValueID value = notif->values.front();
-    Local<Object> valobj = zwaveValue2v8Value(value);
+    ValueInfo *vinfo = get_value_info(value);
+    if (vinfo) {
+      mutex::scoped_lock sl(znodes_mutex);
+      vinfo->cache = ::std::make_shared<CachedValue>(notif->value);
+      touch_value(vinfo);
+    }
+    value_table_update(vinfo);
+    history_record(vinfo, notif->ts);
+    meter_record(vinfo, notif->ts);
+    if (meter_quiet(vinfo) || value_filtered(vinfo) || (vinfo && event_throttled(vinfo->throttle, notif, vinfo->cache))) {
+      break;
+    }
+    value_emitted(vinfo, vinfo ? vinfo->cache.get() : NULL);
+    Local<Object> valobj = zwaveValue2v8Value(value, ValueField_All & ~ValueField_Items, vinfo);
     emitinfo[0] = Nan::New<String>("value changed").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
     emitinfo[2] = Nan::New<Integer>(value.GetCommandClassId());
@@ -224,7 +280,23 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_ValueRefreshed: {
     //                            ####################
     OpenZWave::ValueID value = notif->values.front();
-    Local<Object> valobj = zwaveValue2v8Value(value);
+    ValueInfo *vinfo = get_value_info(value);
+    if (vinfo) {
+      mutex::scoped_lock sl(znodes_mutex);
+      // only a refresh that brought a different value counts as a change
+      if (!cachedValueEquals(value, vinfo->cache.get(), &notif->value)) {
+        touch_value(vinfo);
+      }
+      vinfo->cache = ::std::make_shared<CachedValue>(notif->value);
+    }
+    value_table_update(vinfo);
+    history_record(vinfo, notif->ts);
+    meter_record(vinfo, notif->ts);
+    if (meter_quiet(vinfo) || value_filtered(vinfo) || (vinfo && event_throttled(vinfo->throttle, notif, vinfo->cache))) {
+      break;
+    }
+    value_emitted(vinfo, vinfo ? vinfo->cache.get() : NULL);
+    Local<Object> valobj = zwaveValue2v8Value(value, ValueField_All & ~ValueField_Items, vinfo);
     emitinfo[0] = Nan::New<String>("value refreshed").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
     emitinfo[2] = Nan::New<Integer>(value.GetCommandClassId());
@@ -245,14 +317,26 @@ void handleNotification(NotifInfo *notif)
   //                            ###############
   case OpenZWave::Notification::Type_NodeAdded: {
     //                            ###############
-    node = new NodeInfo();
-    node->homeid = notif->homeid;
-    node->nodeid = notif->nodeid;
-    node->polled = false;
-    {
+    node = get_node_info(notif->nodeid);
+    if (node && node->stale) {
+      // loaded from the warm start file, confirmed now
       mutex::scoped_lock sl(znodes_mutex);
-      znodes[notif->nodeid] = node;
+      node->homeid = notif->homeid;
+      node->stale = false;
+    } else {
+      // a node re-added without having been removed starts afresh
+      delete_node(notif->nodeid);
+      node = new NodeInfo();
+      node->homeid = notif->homeid;
+      node->nodeid = notif->nodeid;
+      node->polled = false;
+      node->stale = false;
+      node->desc.names_valid = false;
+      node->desc.protocol_valid = false;
+      node->throttle = NULL;
+      publish_node(node);
     }
+    profile_node_stage(notif->nodeid, NodeStage_Added, notif->ts);
     emitinfo[0] = Nan::New<String>("node added").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
     emit_cb->Call(Nan::New(ctx_obj),  2, emitinfo, resource);
@@ -271,14 +355,21 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_NodeProtocolInfo: {
     //                            ######################
     /*
-    * Ignore intermediate notifications about a node status, we
-    * wait until the node is ready before retrieving information.
+    * Nothing to emit for intermediate notifications about a node
+    * status, we wait until the node is ready. Just keep what's known.
     */
+    if ((node = get_node_info(notif->nodeid))) {
+      refresh_node_protocol(node->desc, notif->homeid, notif->nodeid);
+    }
+    profile_node_stage(notif->nodeid, NodeStage_ProtocolInfo, notif->ts);
     break;
   }
   //                            ################
   case OpenZWave::Notification::Type_NodeNaming: {
     //                            ################
+    if ((node = get_node_info(notif->nodeid))) {
+      refresh_node_names(node->desc, notif->homeid, notif->nodeid);
+    }
     populateNode(cbinfo, notif->homeid, notif->nodeid);
     emitinfo[0] = Nan::New<String>("node naming").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
@@ -289,6 +380,9 @@ void handleNotification(NotifInfo *notif)
   //                            ###############
   case OpenZWave::Notification::Type_NodeEvent: {
     //                            ###############
+    if ((node = get_node_info(notif->nodeid)) && event_throttled(node->throttle, notif)) {
+      break;
+    }
     emitinfo[0] = Nan::New<String>("node event").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
     emitinfo[2] = Nan::New<Integer>(notif->event);
@@ -300,7 +394,14 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_PollingDisabled: {
     //                            #####################
     if ((node = get_node_info(notif->nodeid))) {
-      node->polled = false;
+      ValueInfo *vinfo = notif->values.empty() ? NULL : get_value_info(notif->values.front());
+      {
+        mutex::scoped_lock sl(znodes_mutex);
+        node->polled = false;
+        if (vinfo) {
+          vinfo->polled = false;
+        }
+      }
       emitinfo[0] = Nan::New<String>("polling disabled").ToLocalChecked();
       emitinfo[1] = Nan::New<Integer>(notif->nodeid);
       emit_cb->Call(Nan::New(ctx_obj),  2, emitinfo, resource);
@@ -311,7 +412,14 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_PollingEnabled: {
     //                            ####################
     if ((node = get_node_info(notif->nodeid))) {
-      node->polled = true;
+      ValueInfo *vinfo = notif->values.empty() ? NULL : get_value_info(notif->values.front());
+      {
+        mutex::scoped_lock sl(znodes_mutex);
+        node->polled = true;
+        if (vinfo) {
+          vinfo->polled = true;
+        }
+      }
       emitinfo[0] = Nan::New<String>("polling enabled").ToLocalChecked();
       emitinfo[1] = Nan::New<Integer>(notif->nodeid);
       emit_cb->Call(Nan::New(ctx_obj),  2, emitinfo, resource);
@@ -368,6 +476,7 @@ void handleNotification(NotifInfo *notif)
     //                            #################
     // the driver is ready, set our global homeid
     homeid = notif->homeid;
+    profile_driver_stage(DriverStage_DriverReady, notif->ts);
     emitinfo[0] = Nan::New<String>("driver ready").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(homeid);
     emit_cb->Call(Nan::New(ctx_obj),  2, emitinfo, resource);
@@ -383,6 +492,7 @@ void handleNotification(NotifInfo *notif)
   //                            ##################################
   case OpenZWave::Notification::Type_EssentialNodeQueriesComplete: {
     //                            ##################################
+    profile_node_stage(notif->nodeid, NodeStage_EssentialQueriesComplete, notif->ts);
     populateNode(cbinfo, notif->homeid, notif->nodeid);
     emitinfo[0] = Nan::New<String>("node available").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
@@ -396,6 +506,15 @@ void handleNotification(NotifInfo *notif)
   //                            #########################
   case OpenZWave::Notification::Type_NodeQueriesComplete: {
     //                            #########################
+    drop_stale(notif->nodeid);
+    profile_node_stage(notif->nodeid, NodeStage_QueriesComplete, notif->ts);
+    // the command classes (and the metadata) are all known by now
+    if ((node = get_node_info(notif->nodeid)) && !node->stale) {
+      refresh_node_classes(node->desc, notif->homeid, notif->nodeid, true);
+#if OPENZWAVE_16
+      refresh_node_metadata(node->desc, notif->homeid, notif->nodeid);
+#endif
+    }
     populateNode(cbinfo, notif->homeid, notif->nodeid);
     emitinfo[0] = Nan::New<String>("node ready").ToLocalChecked();
     emitinfo[1] = Nan::New<Integer>(notif->nodeid);
@@ -412,6 +531,11 @@ void handleNotification(NotifInfo *notif)
   case OpenZWave::Notification::Type_AllNodesQueried:
   case OpenZWave::Notification::Type_AllNodesQueriedSomeDead: {
     //                            #############################
+    // whatever was loaded from the warm start file and not confirmed
+    // by now is gone from the network
+    drop_stale(-1);
+    profile_driver_stage((notif->type == OpenZWave::Notification::Type_AwakeNodesQueried) ?
+      DriverStage_AwakeNodesQueried : DriverStage_AllNodesQueried, notif->ts);
     emitinfo[0] = Nan::New<String>("scan complete").ToLocalChecked();
     emit_cb->Call(Nan::New(ctx_obj),  1, emitinfo, resource);
     break;
@@ -467,6 +591,7 @@ void handleNotification(NotifInfo *notif)
   //                            ################################
   case OpenZWave::Notification::Type_ManufacturerSpecificDBReady: {
   //                            ################################
+    set_metadata_ready(true);
     emitinfo[0] = Nan::New<String>("manufacturer specific DB ready").ToLocalChecked();
     emit_cb->Call(Nan::New(ctx_obj),  1, emitinfo, resource);
     break;    
@@ -524,7 +649,11 @@ void async_cb_handler(uv_async_t *handle)
 #else
     handleNotification(notif);
 #endif
+    memory_count_notif(notif, false);
+    delete notif;
   }
+  // no NodeInfo pointers are held past this point
+  reclaim_nodes();
 }
 
 void async_cb_handler(uv_async_t *handle, int status) {
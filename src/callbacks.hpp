@@ -19,6 +19,39 @@
 
 namespace OZW {
 
+  /*
+  * The typed contents of a value, as last reported by OpenZWave.
+  * Captured on the OZW thread, see captureValue()
+  */
+  typedef struct {
+    bool valid;
+    union {
+      bool   b;
+      uint8  byte;
+      int16  s;
+      int32  i;
+      float  f;
+    } num;
+    uint8 precision;   // Decimal values
+    ::std::string str; // String, List selection, Decimal as string, Raw bytes
+  } CachedValue;
+
+  /*
+  * The static metadata of a value, read along with its contents when
+  * OpenZWave adds it. Captured on the OZW thread, see captureMetadata()
+  */
+  typedef struct {
+    bool valid;
+    ::std::string label;
+    ::std::string units;
+    ::std::string help;
+    bool  read_only;
+    bool  write_only;
+    int32 min;
+    int32 max;
+    bool  polled;
+  } CachedMetadata;
+
   // callback struct to copy data from the OZW thread to the v8 event loop:
   typedef struct {
     uint32 type;
@@ -30,17 +63,236 @@ namespace OZW {
     uint8 sceneid;
     uint8 notification;
     ::std::list<OpenZWave::ValueID> values;
+    // ValueAdded/Changed/Refreshed: the value at the time of notification
+    CachedValue value;
+    // ValueAdded: its metadata
+    CachedMetadata meta;
     ::std::string help;
+    // when OpenZWave sent it, msec since the epoch
+    double ts;
 #if OPENZWAVE_16
     uint8 command;
 #endif
   } NotifInfo;
 
+  /*
+  * Event throttling state of a value or a node, see OZW::Throttle.
+  * At most one event per window goes out, the last one at its end.
+  */
+  typedef struct {
+    uv_timer_t timer;
+    uint32 window;    // msec
+    bool   leading;   // emit the first event of a window right away
+    bool   trailing;  // emit the last event of a window at its end
+    bool   active;    // a window is running
+    bool   pending;   // an event is due at the end of the window
+    uint32 handle;    // the throttled value, or 0 for a node
+    uint8  nodeid;
+    // the pending notification
+    uint32 type;
+    uint8  event;
+    ::std::string help;
+    ::std::shared_ptr<const CachedValue> value; // the value's contents with it
+  } ThrottleInfo;
+
+  /*
+  * Time series of a numeric value, kept in a ring of fixed capacity.
+  * See OZW::RecordHistory
+  */
+  typedef struct {
+    ::std::vector<double> timestamps; // msec since the epoch
+    ::std::vector<double> values;
+    uint32 head;  // the next slot to write to
+    uint32 count;
+  } HistoryInfo;
+
+  /*
+  * Accumulation state of a Meter command class value, for both the
+  * current window (since the last OZW::GetMeterSummary) and in total.
+  * A reading lower than the previous one counts as a counter reset.
+  */
+  typedef struct {
+    double last;          // the last reading
+    double last_ts;       // when it came in, msec since the epoch
+    double window_start;
+    double window_delta;
+    uint32 window_resets;
+    uint32 window_samples;
+    double total_delta;
+    uint32 total_resets;
+    uint32 total_samples;
+  } MeterInfo;
+
+  struct InternEntry;
+
+  /*
+  * A reference to a string in the shared intern table (see
+  * openzwave-strings.cc), so that metadata texts repeated across values
+  * (labels, units, help) are stored, and materialized as V8 strings, only
+  * once. Reference counted, to be used on the V8 thread only.
+  */
+  class InternedString {
+  public:
+    InternedString() : entry(NULL) {}
+    explicit InternedString(::std::string const &str);
+    InternedString(InternedString const &other);
+    InternedString &operator=(InternedString const &other);
+    ~InternedString();
+    ::std::string const &str() const;
+    v8::Local<v8::String> v8str() const;
+  private:
+    InternEntry *entry;
+  };
+
+  // label and help text of a single bit of a BitSet value
+  typedef struct {
+    uint8 pos;
+    InternedString label;
+    InternedString help;
+  } BitInfo;
+
+  /*
+  * Native state for a single ValueID. Lives in its NodeInfo's value list,
+  * so its address is stable until the value (or its node) is removed.
+  */
+  struct ValueInfo {
+    ValueInfo(OpenZWave::ValueID const &_id) :
+      id(_id), handle(0), table_slot(-1), seq(0),
+      deadband_abs(0), deadband_rel(0), emitted(false), last_emitted(0), suppressed(0), throttle(NULL), history(NULL), meter(NULL),
+      stale(false), meta_cached(false), read_only(false), write_only(false), min(0), max(0), polled(false),
+      bits_cached(false), bitmask(0), items_cached(false) {}
+    OpenZWave::ValueID id;
+    // opaque handle passed to JS land, see OZW::ResolveValue
+    uint32 handle;
+    // slot in the value table, -1 if none. See OZW::EnableValueTable
+    int32 table_slot;
+    // sequence number of the last change (0 if none yet), and our
+    // position in the list of values ordered by it. See OZW::ChangesSince
+    uint64 seq;
+    ::std::list<ValueInfo *>::iterator seq_pos;
+    // last known contents, see OZW::GetValue. Never modified in place but
+    // replaced on every update, so snapshots can share it (see Snapshot)
+    ::std::shared_ptr<const CachedValue> cache;
+    // deadband filtering of change events, see OZW::SetDeadband
+    double deadband_abs;
+    double deadband_rel;
+    bool   emitted;      // whether last_emitted is known
+    double last_emitted;
+    uint32 suppressed;
+    // event throttling, NULL if none
+    ThrottleInfo *throttle;
+    // recorded time series, NULL if none
+    HistoryInfo *history;
+    // meter accumulation, NULL if not tracked. See OZW::TrackMeters
+    MeterInfo *meter;
+    // loaded from the warm start file, and not (re)added by OpenZWave yet
+    bool stale;
+    // static metadata, captured when the value got added (or fetched
+    // once, see fetch_value_metadata) and cleared when the label gets changed
+    bool meta_cached;
+    InternedString label;
+    InternedString units;
+    InternedString help;
+    bool  read_only;
+    bool  write_only;
+    int32 min;
+    int32 max;
+    // whether OpenZWave polls it, kept up to date from the
+    // 'polling enabled/disabled' notifications
+    bool  polled;
+    // BitSet values: cached mask and per-bit metadata, cleared when
+    // the mask or the labels get changed
+    bool bits_cached;
+    int32 bitmask;
+    ::std::vector<BitInfo> bits;
+    // List values: the item labels, static for the device
+    bool items_cached;
+    ::std::vector< ::std::string > items;
+  };
+
+  /*
+  * A copy of what a value object is built from, taken from its ValueInfo
+  * under znodes_mutex so that the object can be built (and OpenZWave
+  * asked for whatever isn't cached) after releasing it.
+  * See valueState2v8Value()
+  */
+  struct ValueState {
+    explicit ValueState(ValueInfo *_vinfo) :
+      id(_vinfo->id), cache(_vinfo->cache), stale(_vinfo->stale),
+      meta_cached(_vinfo->meta_cached), label(_vinfo->label), units(_vinfo->units), help(_vinfo->help),
+      read_only(_vinfo->read_only), write_only(_vinfo->write_only), min(_vinfo->min), max(_vinfo->max),
+      polled(_vinfo->polled), vinfo(_vinfo) {}
+    OpenZWave::ValueID id;
+    ::std::shared_ptr<const CachedValue> cache;
+    bool stale;
+    bool meta_cached;
+    InternedString label;
+    InternedString units;
+    InternedString help;
+    bool  read_only;
+    bool  write_only;
+    int32 min;
+    int32 max;
+    bool  polled;
+    // for the metadata not cached yet, the List items and the BitSet
+    // labels, which are only ever filled in on the V8 thread
+    ValueInfo *vinfo;
+  };
+
+  // OpenZWave::Node::MetaData_OzwInfoPage_URL .. MetaData_Identifier
+  #define NODE_METADATA_FIELDS 14
+
+  /*
+  * What OpenZWave knows about a node that only changes on particular
+  * notifications (NodeNaming, NodeProtocolInfo) or through our own
+  * setters, so it's fetched once and served from here. Filled lazily
+  * if needed earlier; only accessed on the V8 thread.
+  */
+  typedef struct {
+    bool names_valid;
+    ::std::string manufacturer;
+    ::std::string manufacturerid;
+    ::std::string product;
+    ::std::string producttype;
+    ::std::string productid;
+    ::std::string type;
+    ::std::string name;
+    ::std::string loc;
+    bool protocol_valid;
+    bool listening;
+    bool frequent_listening;
+    bool beaming;
+    bool routing;
+    bool security_device;
+    uint32 max_baud_rate;
+    uint8 version;
+    uint8 security;
+    uint8 basic;
+    uint8 generic;
+    uint8 specific;
+    // supported command classes, one bit per class id, and their versions.
+    // Refreshed when the node's queries complete
+    bool classes_valid;
+    uint32 class_bits[8];
+    uint8 class_versions[256];
+    // device database metadata, by MetaDataFields (OpenZWave 1.6).
+    // Refreshed when the database and the node are ready
+    bool metadata_valid;
+    ::std::string metadata[NODE_METADATA_FIELDS];
+  } NodeDescriptor;
+
   typedef struct {
     uint32 homeid;
     uint8  nodeid;
     bool   polled;
-    ::std::list<OpenZWave::ValueID> values;
+    // loaded from the warm start file, and not (re)added by OpenZWave yet
+    bool   stale;
+    // bumped every time a node gets published in this slot, see get_node_handle
+    uint32 generation;
+    NodeDescriptor desc;
+    ::std::list<ValueInfo> values;
+    // node event throttling, NULL if none
+    ThrottleInfo *throttle;
   } NodeInfo;
 
   typedef struct {
@@ -78,10 +330,26 @@ namespace OZW {
   extern ::std::queue<NotifInfo *> zqueue;
 
   /*
-  * Node state.
+  * Node state: one slot per node id, read without locking (see
+  * get_node_info). znodes_mutex serializes the writers, and guards the
+  * value lists of the nodes.
   */
+  #define NODE_SLOTS 256
   extern mutex znodes_mutex;
-  extern ::std::map<uint8_t, NodeInfo *> znodes;
+  extern ::std::atomic<NodeInfo *> znodes[NODE_SLOTS];
+
+  /*
+  * Value handle table. A handle is (generation << HANDLE_SLOT_BITS | slot + 1):
+  * slots get reused once their value is removed, and the generation bumped,
+  * so handles to removed values fail to resolve. Guarded by znodes_mutex.
+  */
+  #define HANDLE_SLOT_BITS 20
+  #define HANDLE_SLOT_MASK ((1 << HANDLE_SLOT_BITS) - 1)
+  typedef struct {
+    ValueInfo *vinfo;   // NULL if free
+    uint32 generation;
+  } ValueHandleSlot;
+  extern ::std::vector<ValueHandleSlot> zvalues;
 
   extern mutex zscenes_mutex;
   extern ::std::list<SceneInfo *> zscenes;
@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <deque>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+// how many value removals to remember for changesSince()
+#define REMOVED_LOG_SIZE 1024
+
+namespace OZW {
+
+	typedef struct {
+		uint64 seq;
+		::std::string value_id;
+	} RemovedValue;
+
+	/*
+	* Change tracking state, guarded by znodes_mutex: every value added
+	* or changed gets the next sequence number and moves to the tail of
+	* zchanges, which is thus always ordered by sequence. Removals go to a
+	* bounded log; zremoved_floor is the last sequence dropped from it.
+	*/
+	static uint64 zseq = 0;
+	static ::std::list<ValueInfo *> zchanges;
+	static ::std::deque<RemovedValue> zremoved;
+	static uint64 zremoved_floor = 0;
+
+	uint64 get_value_seq()
+	{
+		return zseq;
+	}
+
+	void touch_value(ValueInfo *vinfo)
+	{
+		if (vinfo->seq > 0) {
+			zchanges.erase(vinfo->seq_pos);
+		}
+		vinfo->seq = ++zseq;
+		vinfo->seq_pos = zchanges.insert(zchanges.end(), vinfo);
+	}
+
+	void forget_value(ValueInfo *vinfo)
+	{
+		if (vinfo->seq == 0) {
+			return;
+		}
+		zchanges.erase(vinfo->seq_pos);
+		vinfo->seq = 0;
+
+		RemovedValue removed;
+		removed.seq = ++zseq;
+		removed.value_id = getValueIdDescriptor(vinfo->id);
+		zremoved.push_back(removed);
+		if (zremoved.size() > REMOVED_LOG_SIZE) {
+			zremoved_floor = zremoved.front().seq;
+			zremoved.pop_front();
+		}
+	}
+
+	/*
+	* Get the values added or changed after sequence number 'seq', and
+	* the value_ids of those removed since. When the removals are too
+	* old to be known anymore, or 'seq' is ahead of us (it came from
+	* before a restart), 'reset' is true and 'values' holds all values,
+	* to replace the caller's state with.
+	* Returns { seq, reset, values, removed }
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::ChangesSince)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "seq");
+		double since_arg = Nan::To<double>(info[0]).FromMaybe(0);
+		uint32 fields = ValueField_All & ~ValueField_Items;
+		if ((info.Length() > 1) && info[1]->IsNumber()) {
+			fields = Nan::To<uint32_t>(info[1]).FromJust();
+		}
+
+		Local<Object> result = Nan::New<Object>();
+		Local<Array> removed = Nan::New<Array>();
+		::std::vector<ValueState> changed;
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			bool reset = (since_arg > (double) zseq);
+			uint64 since = (!reset && (since_arg > 0)) ? (uint64) since_arg : 0;
+			reset = reset || (since < zremoved_floor);
+			if (reset) {
+				since = 0;
+			}
+
+			// walk back to the first value changed after 'since'
+			::std::list<ValueInfo *>::iterator it = zchanges.end();
+			while ((it != zchanges.begin()) && ((*::std::prev(it))->seq > since)) {
+				--it;
+			}
+			// only copied here, the value objects get built after unlocking
+			for (; it != zchanges.end(); ++it) {
+				changed.push_back(ValueState(*it));
+			}
+
+			if (!reset) {
+				::std::deque<RemovedValue>::iterator rit = zremoved.end();
+				while ((rit != zremoved.begin()) && ((rit - 1)->seq > since)) {
+					--rit;
+				}
+				uint32 idx = 0;
+				for (; rit != zremoved.end(); ++rit) {
+					Nan::Set(removed, idx++, Nan::New<String>(rit->value_id).ToLocalChecked());
+				}
+			}
+
+			AddNumberProp(result, seq, (double) zseq);
+			AddBooleanProp(result, reset, reset);
+		}
+		Local<Array> values = Nan::New<Array>(changed.size());
+		for (uint32 idx = 0; idx < changed.size(); idx++) {
+			Nan::Set(values, idx, valueState2v8Value(changed[idx], fields));
+		}
+		Nan::Set(result, Nan::New<String>("values").ToLocalChecked(), values);
+		Nan::Set(result, Nan::New<String>("removed").ToLocalChecked(), removed);
+		info.GetReturnValue().Set(result);
+	}
+}
@@ -33,6 +33,10 @@ NAN_METHOD(OZW::Connect)
 	::std::string path(*Nan::Utf8String(info[0]));
 
 	uv_async_init(uv_default_loop(), &async, async_cb_handler);
+	profile_driver_stage(DriverStage_Connect, nowMsec());
+#if OPENZWAVE_16
+	set_metadata_ready(false);
+#endif
 
 	OZW *self = ObjectWrap::Unwrap<OZW>(info.This());
 	::std::string version("");
@@ -61,6 +65,8 @@ NAN_METHOD(OZW::Connect)
 	cbinfo[1] = Nan::New<String>(version).ToLocalChecked();
 
 	emit_cb->Call(Nan::New(ctx_obj), 2, cbinfo, resource);
+
+	warmstart_start(self->userpath);
 }
 
 // ===================================================================
@@ -108,6 +114,14 @@ NAN_METHOD(OZW::UpdateOptions)
 			{
 				log_initialisation = (Nan::To<bool>(argval) == Nan::Just(true));
 			}
+			else if (keyname == "DecimalAsNumber")
+			{
+				decimal_as_number = (Nan::To<bool>(argval) == Nan::Just(true));
+			}
+			else if (keyname == "WarmStartInterval")
+			{
+				warmstart_interval = Nan::To<uint32>(argval).FromJust();
+			}
 			else
 			{
 				option_overrides += " --" + keyname + " " + argvalstr;
@@ -150,6 +164,7 @@ NAN_METHOD(OZW::Disconnect)
 	CheckMinArgs(1, "path");
 	::std::string path(*Nan::Utf8String(info[0]));
 
+	warmstart_stop();
 	OZWManager(RemoveDriver, path);
 	OZWManager(RemoveWatcher, ozw_watcher_callback, NULL);
 #if OPENZWAVE_EXCEPTIONS
@@ -168,6 +183,8 @@ NAN_METHOD(OZW::Disconnect)
 		Nan::ThrowError(buffer);
 	}
 #endif
+	// the network is gone, and so is everything we knew about it
+	clear_nodes();
 	// FIXME: seems some recent innocuous change in NaN causes the context (ctx_obj) to be freed.
 	// Therefore, deleting this V8 resource will cause V8 to crash. NOT deleting it could memleak
 	// when you're reloading the driver.
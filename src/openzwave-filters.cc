@@ -0,0 +1,311 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <cmath>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	// total number of change events suppressed by deadbands
+	static uint32 zsuppressed = 0;
+
+	/*
+	* Decide whether to suppress the change event of a value, judging by
+	* its deadband: the event goes out when the new contents differ from
+	* the last emitted ones by at least one of the thresholds set. There's
+	* nothing to be relative to when the last emitted value was 0, so then
+	* any change at all passes the relative threshold.
+	*/
+	bool value_filtered(ValueInfo *vinfo)
+	{
+		if (!vinfo || ((vinfo->deadband_abs <= 0) && (vinfo->deadband_rel <= 0))) {
+			return false;
+		}
+		double val;
+		if (!vinfo->emitted || !cachedValueAsDouble(vinfo->id, vinfo->cache.get(), &val)) {
+			return false;
+		}
+		double delta = fabs(val - vinfo->last_emitted);
+		bool abs_exceeded = (vinfo->deadband_abs > 0) && (delta >= vinfo->deadband_abs);
+		bool rel_exceeded = (vinfo->deadband_rel > 0) && (delta > 0)
+			&& ((vinfo->last_emitted == 0) || (delta >= vinfo->deadband_rel * fabs(vinfo->last_emitted)));
+		if (abs_exceeded || rel_exceeded) {
+			return false;
+		}
+		vinfo->suppressed++;
+		zsuppressed++;
+		return true;
+	}
+
+	// the change event of a value went out with these contents: the deadband's new reference
+	void value_emitted(ValueInfo *vinfo, CachedValue const *cache)
+	{
+		double val;
+		if (vinfo && ((vinfo->deadband_abs > 0) || (vinfo->deadband_rel > 0))
+				&& cachedValueAsDouble(vinfo->id, cache, &val)) {
+			vinfo->emitted = true;
+			vinfo->last_emitted = val;
+		}
+	}
+
+	/*
+	* Emit the event a throttle has been holding back, from the contents
+	* captured with it. A value event is shaped like the one emitted
+	* directly, with its metadata taken from the ValueInfo (cached when
+	* the value got added): no Manager calls.
+	*/
+	static void emitThrottled(ThrottleInfo *t)
+	{
+		Nan::HandleScope scope;
+		Local<v8::Value> emitinfo[4];
+		if (t->handle) {
+			ValueInfo *vinfo = get_value_by_handle(t->handle);
+			if (!vinfo) {
+				return;
+			}
+			const char *name = (t->type == OpenZWave::Notification::Type_ValueRefreshed)
+				? "value refreshed" : "value changed";
+			emitinfo[0] = Nan::New<String>(name).ToLocalChecked();
+			emitinfo[1] = Nan::New<Integer>(t->nodeid);
+			ValueState vs(vinfo);
+			// the contents as they were when the event got held back
+			vs.cache = t->value;
+			emitinfo[2] = Nan::New<Integer>(vinfo->id.GetCommandClassId());
+			emitinfo[3] = valueState2v8Value(vs, ValueField_All & ~ValueField_Items);
+			value_emitted(vinfo, t->value.get());
+			t->value.reset();
+		} else {
+			emitinfo[0] = Nan::New<String>("node event").ToLocalChecked();
+			emitinfo[1] = Nan::New<Integer>(t->nodeid);
+			emitinfo[2] = Nan::New<Integer>(t->event);
+			emitinfo[3] = Nan::New<String>(t->help.c_str()).ToLocalChecked();
+		}
+		emit_cb->Call(Nan::New(ctx_obj), 4, emitinfo, resource);
+	}
+
+	// end of a throttle window
+	static void throttle_timer_cb(uv_timer_t *handle)
+	{
+		ThrottleInfo *t = (ThrottleInfo *) handle->data;
+		if (t->pending) {
+			// deliver the final state, and keep throttling for another window
+			t->pending = false;
+			emitThrottled(t);
+		} else {
+			t->active = false;
+			uv_timer_stop(handle);
+		}
+	}
+
+	static void throttle_timer_cb(uv_timer_t *handle, int status)
+	{
+		throttle_timer_cb(handle);
+	}
+
+	static void throttle_close_cb(uv_handle_t *handle)
+	{
+		delete (ThrottleInfo *) handle->data;
+	}
+
+	/*
+	* Decide whether to hold back an event of a throttled value or node.
+	*/
+	bool event_throttled(ThrottleInfo *t, NotifInfo *notif, ::std::shared_ptr<const CachedValue> const &value)
+	{
+		if (!t) {
+			return false;
+		}
+		if (!t->active) {
+			t->active = true;
+			uv_timer_start(&t->timer, throttle_timer_cb, t->window, t->window);
+			if (t->leading) {
+				return false;
+			}
+		}
+		// a pending 'value changed' wins over a 'value refreshed'
+		if (!t->pending || (notif->type != OpenZWave::Notification::Type_ValueRefreshed)) {
+			t->type = notif->type;
+		}
+		t->event = notif->event;
+		t->help = notif->help;
+		t->value = value;
+		t->pending = t->trailing;
+		return true;
+	}
+
+	void release_throttle(ThrottleInfo *t)
+	{
+		if (t) {
+			uv_timer_stop(&t->timer);
+			uv_close((uv_handle_t *) &t->timer, throttle_close_cb);
+		}
+	}
+
+	static double getDeadbandArg(Local<Object> opts, const char *name)
+	{
+		Local<Value> v = Nan::Get(opts, Nan::New<String>(name).ToLocalChecked()).ToLocalChecked();
+		return v->IsNumber() ? Nan::To<double>(v).FromJust() : 0;
+	}
+
+	/*
+	* Set the deadband of a numeric value: change events within
+	* 'absolute' units or 'relative' fraction (eg. 0.01 for 1%) of the last
+	* emitted value are dropped natively (the cached value is still updated).
+	* Pass null to remove it.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::SetDeadband)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(2, "valueId, deadband");
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo) {
+			uint8 optidx = (info[0]->IsObject()) ? 1 : 4;
+			double val;
+			switch (vinfo->id.GetType()) {
+				case OpenZWave::ValueID::ValueType_Byte:
+				case OpenZWave::ValueID::ValueType_Short:
+				case OpenZWave::ValueID::ValueType_Int:
+				case OpenZWave::ValueID::ValueType_Decimal:
+					break;
+				default:
+					Nan::ThrowTypeError("deadbands can only be set on numeric (byte, short, int, decimal) values");
+					return;
+			}
+			vinfo->deadband_abs = 0;
+			vinfo->deadband_rel = 0;
+			if ((info.Length() > optidx) && info[optidx]->IsObject()) {
+				Local<Object> opts = Nan::To<Object>(info[optidx]).ToLocalChecked();
+				vinfo->deadband_abs = getDeadbandArg(opts, "absolute");
+				vinfo->deadband_rel = getDeadbandArg(opts, "relative");
+			}
+			// the current contents were the last to be emitted
+			vinfo->emitted = cachedValueAsDouble(vinfo->id, vinfo->cache.get(), &val);
+			vinfo->last_emitted = vinfo->emitted ? val : 0;
+		}
+	}
+
+	/*
+	* Get the number of change events suppressed by deadbands, in total
+	* and per value_id (for the values with a deadband set).
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetDeadbandStats)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		Local<Object> stats = Nan::New<Object>();
+		Local<Object> values = Nan::New<Object>();
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			NodeInfo *node;
+			::std::list<ValueInfo>::iterator vit;
+			for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+				if (!(node = get_node_info(nodeid))) {
+					continue;
+				}
+				for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+					if ((vit->deadband_abs > 0) || (vit->deadband_rel > 0)) {
+						Nan::Set(values,
+							Nan::New<String>(getValueIdDescriptor(vit->id)).ToLocalChecked(),
+							Nan::New<Integer>(vit->suppressed));
+					}
+				}
+			}
+		}
+		AddIntegerProp(stats, suppressed, zsuppressed);
+		Nan::Set(stats, Nan::New<String>("values").ToLocalChecked(), values);
+		info.GetReturnValue().Set(stats);
+	}
+
+	static bool getThrottleArg(Local<Object> opts, const char *name, bool def)
+	{
+		Local<Value> v = Nan::Get(opts, Nan::New<String>(name).ToLocalChecked()).ToLocalChecked();
+		return v->IsBoolean() ? Nan::To<bool>(v).FromJust() : def;
+	}
+
+	/*
+	* Throttle the change events of a value (given a valueId object) or
+	* the 'node event's of a node (given its id) to at most one per 'msec'
+	* window. 'leading' emits the first event of a window right away,
+	* 'trailing' the last one at its end (both default to true).
+	* A window of 0 removes the throttle, and it can't be longer than
+	* 4294967295 msec (about 49 days).
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::Throttle)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(2, "valueId|nodeId, msec");
+		ThrottleInfo **tp = NULL;
+		uint32 handle = 0;
+		uint8 nodeid = 0;
+		if (info[0]->IsObject()) {
+			ValueInfo* vinfo = populateValueInfo(info);
+			if (!vinfo) {
+				return;
+			}
+			tp = &vinfo->throttle;
+			handle = vinfo->handle;
+			nodeid = vinfo->id.GetNodeId();
+		} else {
+			nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
+			NodeInfo *node = get_node_info(nodeid);
+			if (!node) {
+				Nan::ThrowError("OpenZWave node not found");
+				return;
+			}
+			tp = &node->throttle;
+		}
+		double window = Nan::To<double>(info[1]).FromMaybe(-1);
+		if (!(window >= 0) || (window > UINT32_MAX)) {
+			Nan::ThrowRangeError("throttle window must be between 0 and 4294967295 msec");
+			return;
+		}
+		bool leading = true, trailing = true;
+		if ((info.Length() > 2) && info[2]->IsObject()) {
+			Local<Object> opts = Nan::To<Object>(info[2]).ToLocalChecked();
+			leading  = getThrottleArg(opts, "leading", true);
+			trailing = getThrottleArg(opts, "trailing", true);
+		}
+		if (!leading && !trailing) {
+			Nan::ThrowError("throttle: at least one of leading or trailing must be set");
+			return;
+		}
+
+		release_throttle(*tp);
+		*tp = NULL;
+		if ((uint32) window == 0) {
+			return;
+		}
+		ThrottleInfo *t = new ThrottleInfo();
+		t->window   = (uint32) window;
+		t->leading  = leading;
+		t->trailing = trailing;
+		t->active   = false;
+		t->pending  = false;
+		t->handle   = handle;
+		t->nodeid   = nodeid;
+		uv_timer_init(uv_default_loop(), &t->timer);
+		t->timer.data = t;
+		*tp = t;
+	}
+}
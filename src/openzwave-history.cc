@@ -0,0 +1,213 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <cmath>
+#include <limits>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	// samples kept per value (16 bytes each) and buckets per query at most
+	#define HISTORY_MAX_CAPACITY 1048576
+	#define HISTORY_MAX_BUCKETS  65536
+
+	/*
+	* Append the current contents of a value to its history, if it's
+	* being recorded, as of 'ts' (when OpenZWave notified of it).
+	* Called from the notification handler.
+	*/
+	void history_record(ValueInfo *vinfo, double ts)
+	{
+		double val;
+		if (!vinfo || !vinfo->history || !cachedValueAsDouble(vinfo->id, vinfo->cache.get(), &val)) {
+			return;
+		}
+		HistoryInfo *h = vinfo->history;
+		h->timestamps[h->head] = ts;
+		h->values[h->head] = val;
+		h->head = (h->head + 1) % h->values.size();
+		if (h->count < h->values.size()) {
+			h->count++;
+		}
+	}
+
+	// a new Float64Array in o[name], NULL (and throws) if out of memory
+	static double *newFloat64Array(Local<Object> o, const char *name, uint32 length)
+	{
+		Nan::HandleScope scope;
+		void *mem;
+		Local<ArrayBuffer> ab = newExternalArrayBuffer(length * sizeof(double), &mem);
+		if (mem) {
+			Nan::Set(o, Nan::New<String>(name).ToLocalChecked(), Float64Array::New(ab, 0, length));
+		}
+		return (double *) mem;
+	}
+
+	/*
+	* Start (or stop, with a capacity of 0) recording the history of a
+	* numeric value, keeping the last 'capacity' samples (default 1440,
+	* at most 1048576).
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::RecordHistory)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "valueId");
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo) {
+			switch (vinfo->id.GetType()) {
+				case OpenZWave::ValueID::ValueType_Bool:
+				case OpenZWave::ValueID::ValueType_Byte:
+				case OpenZWave::ValueID::ValueType_Short:
+				case OpenZWave::ValueID::ValueType_Int:
+				case OpenZWave::ValueID::ValueType_Decimal:
+					break;
+				default:
+					Nan::ThrowTypeError("history can only be recorded for numeric (bool, byte, short, int, decimal) values");
+					return;
+			}
+			uint8 optidx = (info[0]->IsObject()) ? 1 : 4;
+			uint32 capacity = 1440;
+			if ((info.Length() > optidx) && info[optidx]->IsObject()) {
+				Local<Object> opts = Nan::To<Object>(info[optidx]).ToLocalChecked();
+				Local<Value> cap = Nan::Get(opts, Nan::New<String>("capacity").ToLocalChecked()).ToLocalChecked();
+				if (cap->IsNumber()) {
+					capacity = Nan::To<uint32_t>(cap).FromJust();
+				}
+			}
+			if (capacity > HISTORY_MAX_CAPACITY) {
+				Nan::ThrowRangeError("history capacity must not exceed 1048576 samples");
+				return;
+			}
+			delete vinfo->history;
+			vinfo->history = NULL;
+			if (capacity > 0) {
+				HistoryInfo *h = new HistoryInfo();
+				try {
+					h->timestamps.resize(capacity);
+					h->values.resize(capacity);
+				} catch (::std::bad_alloc const &) {
+					delete h;
+					Nan::ThrowError("out of memory allocating the history");
+					return;
+				}
+				h->head = 0;
+				h->count = 0;
+				vinfo->history = h;
+			}
+		}
+	}
+
+	/*
+	* Aggregate the recorded history of a value over [from, to) (msec since
+	* the epoch) in buckets of bucketMsec. Returns typed arrays with one entry
+	* per bucket: { timestamps (bucket start), min, max, avg, last, count }.
+	* Empty buckets have a count of 0 and NaN aggregates. At most 65536
+	* buckets per query.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::QueryHistory)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		ValueInfo* vinfo = NULL;
+		uint8 argidx = 0;
+		if ((info.Length() > 0) && info[0]->IsObject()) {
+			CheckMinArgs(4, "valueId, from, to, bucketMsec");
+			argidx = 1;
+		} else {
+			CheckMinArgs(7, "nodeid, class_id, instance, index, from, to, bucketMsec");
+			argidx = 4;
+		}
+		if (info.Length() < argidx + 3) {
+			return;
+		}
+		vinfo = populateValueInfo(info);
+		if (!vinfo) {
+			return;
+		}
+		if (!vinfo->history) {
+			Nan::ThrowError("history is not being recorded for this value, see recordHistory()");
+			return;
+		}
+		double from   = Nan::To<double>(info[argidx]).FromJust();
+		double to     = Nan::To<double>(info[argidx + 1]).FromJust();
+		double bucket = Nan::To<double>(info[argidx + 2]).FromJust();
+		if (!(bucket > 0) || !(to > from)) {
+			Nan::ThrowRangeError("queryHistory: need from < to, and a positive bucket size");
+			return;
+		}
+		double buckets = ceil((to - from) / bucket);
+		if (buckets > HISTORY_MAX_BUCKETS) {
+			Nan::ThrowRangeError("queryHistory: too many buckets (at most 65536), use a larger bucket size");
+			return;
+		}
+		uint32 nbuckets = (uint32) buckets;
+
+		Local<Object> result = Nan::New<Object>();
+		double *timestamps, *mins, *maxs, *avgs, *lasts, *counts;
+		if (!(timestamps = newFloat64Array(result, "timestamps", nbuckets))
+				|| !(mins   = newFloat64Array(result, "min", nbuckets))
+				|| !(maxs   = newFloat64Array(result, "max", nbuckets))
+				|| !(avgs   = newFloat64Array(result, "avg", nbuckets))
+				|| !(lasts  = newFloat64Array(result, "last", nbuckets))
+				|| !(counts = newFloat64Array(result, "count", nbuckets))) {
+			return;
+		}
+
+		const double nan = ::std::numeric_limits<double>::quiet_NaN();
+		for (uint32 b = 0; b < nbuckets; b++) {
+			timestamps[b] = from + b * bucket;
+			mins[b] = maxs[b] = lasts[b] = nan;
+			avgs[b] = 0;
+		}
+
+		// walk the ring from the oldest sample on, so 'last' ends up right
+		HistoryInfo *h = vinfo->history;
+		uint32 size = h->values.size();
+		uint32 start = (h->head + size - h->count) % size;
+		for (uint32 i = 0; i < h->count; i++) {
+			uint32 pos = (start + i) % size;
+			double ts = h->timestamps[pos];
+			if ((ts < from) || (ts >= to)) {
+				continue;
+			}
+			uint32 b = (uint32) ((ts - from) / bucket);
+			// rounding can put a sample just before 'to' past the last bucket
+			if (b >= nbuckets) {
+				b = nbuckets - 1;
+			}
+			double val = h->values[pos];
+			if (counts[b] == 0) {
+				mins[b] = maxs[b] = val;
+			} else {
+				if (val < mins[b]) mins[b] = val;
+				if (val > maxs[b]) maxs[b] = val;
+			}
+			avgs[b] += val;
+			lasts[b] = val;
+			counts[b]++;
+		}
+		for (uint32 b = 0; b < nbuckets; b++) {
+			avgs[b] = (counts[b] > 0) ? avgs[b] / counts[b] : nan;
+		}
+		info.GetReturnValue().Set(result);
+	}
+}
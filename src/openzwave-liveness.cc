@@ -0,0 +1,253 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <cstring>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	/*
+	* Liveness of every node id, kept up to date from the notifications:
+	* its status (see NodeLiveness), when it was last heard from (0 if
+	* never) and when it was added, which counts as the start of its
+	* silence until it's heard from. Only accessed on the V8 thread.
+	*/
+	static uint8  zliveness[NODE_SLOTS];
+	static double zlast_seen[NODE_SLOTS];
+	static double zadded[NODE_SLOTS];
+	// whether the current silence of a node has been reported already
+	static bool   zsilent[NODE_SLOTS];
+
+	// see OZW::SetSilenceThreshold
+	static uint32 zsilence_threshold = 0;  // msec, 0 if disabled
+	static uv_timer_t zsilence_timer;
+	static bool zsilence_timer_active = false;   // initialized
+	static bool zsilence_timer_running = false;
+
+	static void silence_timer_start();
+
+	// the status of a node (see NodeLiveness), Unknown until its queries are done
+	uint8 get_node_liveness(uint8 nodeid)
+	{
+		return zliveness[nodeid];
+	}
+
+	static void liveness_seen(uint8 nodeid, double ts)
+	{
+		if (ts > zlast_seen[nodeid]) {
+			zlast_seen[nodeid] = ts;
+		}
+		zsilent[nodeid] = false;
+	}
+
+	// initial status of a node whose queries are done, if no notification told yet
+	static void liveness_init(uint8 nodeid, uint32 homeid)
+	{
+		if (zliveness[nodeid] != NodeLiveness_Unknown) {
+			return;
+		}
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		bool failed = false, awake = false;
+		OZWManagerAssign(failed, IsNodeFailed, homeid, nodeid);
+		if (failed) {
+			zliveness[nodeid] = NodeLiveness_Dead;
+		} else if (!desc || desc->listening || desc->frequent_listening) {
+			zliveness[nodeid] = NodeLiveness_Alive;
+		} else {
+			OZWManagerAssign(awake, IsNodeAwake, homeid, nodeid);
+			zliveness[nodeid] = awake ? NodeLiveness_Awake : NodeLiveness_Asleep;
+		}
+	}
+
+	/*
+	* Account for a notification. Anything that came from a node over the
+	* air counts as hearing from it. Called from the notification handler.
+	*/
+	void liveness_record(NotifInfo *notif)
+	{
+		uint8 nodeid = notif->nodeid;
+		switch (notif->type) {
+		case OpenZWave::Notification::Type_NodeAdded:
+			zliveness[nodeid]  = NodeLiveness_Unknown;
+			zlast_seen[nodeid] = 0;
+			zadded[nodeid]     = notif->ts;
+			zsilent[nodeid]    = false;
+			// stopped by liveness_clear(), if connecting again
+			silence_timer_start();
+			break;
+		case OpenZWave::Notification::Type_NodeRemoved:
+#if OPENZWAVE_16
+		case OpenZWave::Notification::Type_NodeReset:
+#endif
+			zliveness[nodeid]  = NodeLiveness_Unknown;
+			zlast_seen[nodeid] = 0;
+			zadded[nodeid]     = 0;
+			zsilent[nodeid]    = false;
+			break;
+		case OpenZWave::Notification::Type_ValueChanged:
+		case OpenZWave::Notification::Type_ValueRefreshed:
+		case OpenZWave::Notification::Type_NodeEvent:
+		case OpenZWave::Notification::Type_NodeProtocolInfo:
+			liveness_seen(nodeid, notif->ts);
+			break;
+		case OpenZWave::Notification::Type_EssentialNodeQueriesComplete:
+		case OpenZWave::Notification::Type_NodeQueriesComplete:
+			liveness_init(nodeid, notif->homeid);
+			break;
+		case OpenZWave::Notification::Type_Notification:
+			switch (notif->notification) {
+			case OpenZWave::Notification::Code_Awake:
+				zliveness[nodeid] = NodeLiveness_Awake;
+				liveness_seen(nodeid, notif->ts);
+				break;
+			case OpenZWave::Notification::Code_Sleep:
+				// going back to sleep right after talking to us
+				zliveness[nodeid] = NodeLiveness_Asleep;
+				liveness_seen(nodeid, notif->ts);
+				break;
+			case OpenZWave::Notification::Code_Alive:
+				zliveness[nodeid] = NodeLiveness_Alive;
+				liveness_seen(nodeid, notif->ts);
+				break;
+			case OpenZWave::Notification::Code_Dead:
+				zliveness[nodeid] = NodeLiveness_Dead;
+				break;
+			}
+			break;
+		}
+	}
+
+	// report the nodes that just went silent for longer than the threshold
+	static void silence_timer_cb(uv_timer_t *handle)
+	{
+		Nan::HandleScope scope;
+		double now = nowMsec();
+		for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+			if ((zadded[nodeid] == 0) || zsilent[nodeid]) {
+				continue;
+			}
+			double since = (zlast_seen[nodeid] > 0) ? zlast_seen[nodeid] : zadded[nodeid];
+			if ((now - since) < zsilence_threshold) {
+				continue;
+			}
+			zsilent[nodeid] = true;
+			Local<v8::Value> emitinfo[3];
+			emitinfo[0] = Nan::New<String>("node silent").ToLocalChecked();
+			emitinfo[1] = Nan::New<Integer>(nodeid);
+			emitinfo[2] = Nan::New<Number>(zlast_seen[nodeid]);
+			emit_cb->Call(Nan::New(ctx_obj), 3, emitinfo, resource);
+		}
+	}
+
+	static void silence_timer_cb(uv_timer_t *handle, int status)
+	{
+		silence_timer_cb(handle);
+	}
+
+	// (re)start the silence checks, if a threshold is set and they aren't running
+	static void silence_timer_start()
+	{
+		if ((zsilence_threshold == 0) || zsilence_timer_running) {
+			return;
+		}
+		if (!zsilence_timer_active) {
+			uv_timer_init(uv_default_loop(), &zsilence_timer);
+			// not a reason to keep the process alive
+			uv_unref((uv_handle_t *) &zsilence_timer);
+			zsilence_timer_active = true;
+		}
+		// check often enough for the events to be on time within a tenth
+		uint32 period = ::std::min< uint32 >(::std::max< uint32 >(zsilence_threshold / 10, 1000), 60000);
+		uv_timer_start(&zsilence_timer, silence_timer_cb, period, period);
+		zsilence_timer_running = true;
+	}
+
+	static void silence_timer_stop()
+	{
+		if (zsilence_timer_running) {
+			uv_timer_stop(&zsilence_timer);
+			zsilence_timer_running = false;
+		}
+	}
+
+	/*
+	* Forget the liveness of all nodes, on disconnect. The silence checks
+	* stop until a node gets added again, the threshold is kept.
+	*/
+	void liveness_clear()
+	{
+		memset(zliveness, 0, sizeof(zliveness));
+		memset(zlast_seen, 0, sizeof(zlast_seen));
+		memset(zadded, 0, sizeof(zadded));
+		memset(zsilent, 0, sizeof(zsilent));
+		silence_timer_stop();
+	}
+
+	/*
+	* Get the liveness of all nodes in one call, as typed arrays indexed by
+	* node id: status (see NodeLiveness) and lastSeen, when each was last
+	* heard from (msec since the epoch, 0 if never).
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetLiveness)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		void *status, *last_seen;
+		Local<ArrayBuffer> status_ab    = newExternalArrayBuffer(sizeof(zliveness), &status);
+		if (!status) {
+			return;
+		}
+		Local<ArrayBuffer> last_seen_ab = newExternalArrayBuffer(sizeof(zlast_seen), &last_seen);
+		if (!last_seen) {
+			return;
+		}
+		memcpy(status, zliveness, sizeof(zliveness));
+		memcpy(last_seen, zlast_seen, sizeof(zlast_seen));
+		Local<Object> o = Nan::New<Object>();
+		Nan::Set(o, Nan::New<String>("status").ToLocalChecked(),
+			Uint8Array::New(status_ab, 0, NODE_SLOTS));
+		Nan::Set(o, Nan::New<String>("lastSeen").ToLocalChecked(),
+			Float64Array::New(last_seen_ab, 0, NODE_SLOTS));
+		info.GetReturnValue().Set(o);
+	}
+
+	/*
+	* Emit a 'node silent' event (nodeid, lastSeen) once a node hasn't been
+	* heard from for 'seconds', or since it was added. Once per silence:
+	* hearing from the node again rearms it. 0 disables it (the default),
+	* and it can't be longer than 4294967 seconds (about 49 days).
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::SetSilenceThreshold)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "seconds");
+		double seconds = Nan::To<double>(info[0]).FromMaybe(0);
+		if (!(seconds >= 0) || (seconds * 1000 > UINT32_MAX)) {
+			Nan::ThrowRangeError("silence threshold must be between 0 and 4294967 seconds");
+			return;
+		}
+		zsilence_threshold = seconds * 1000;
+		// restarted with the period for the new threshold
+		silence_timer_stop();
+		silence_timer_start();
+	}
+}
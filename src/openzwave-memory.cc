@@ -0,0 +1,313 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+// one counter slot per notification type, the last one for controller commands
+#define NOTIF_SLOTS 64
+#define NOTIF_SLOT_CONTROLLER_COMMAND (NOTIF_SLOTS - 1)
+
+// std::list node overhead: the prev/next pointers
+#define LIST_NODE_BYTES (2 * sizeof(void *))
+
+namespace OZW {
+
+	/*
+	* NotifInfo allocations are counted on the OpenZWave thread and frees on
+	* the V8 thread, hence the atomics. NodeInfos only live on the V8 thread.
+	*/
+	static ::std::atomic<uint64> znotif_allocated[NOTIF_SLOTS];
+	static ::std::atomic<uint64> znotif_freed[NOTIF_SLOTS];
+	static uint64 znodes_allocated = 0;
+	static uint64 znodes_freed = 0;
+
+	// the allocation counts as of the previous OZW::GetMemoryStats, for the rates
+	static uint64 zlast_allocated[NOTIF_SLOTS];
+	static double zlast_stats_ts = 0;
+
+	static uint32 notifSlot(NotifInfo const *notif)
+	{
+		// same guard as in async_cb_handler
+		if (notif->homeid == 0) {
+			return NOTIF_SLOT_CONTROLLER_COMMAND;
+		}
+		return (notif->type < NOTIF_SLOT_CONTROLLER_COMMAND) ?
+			notif->type : NOTIF_SLOT_CONTROLLER_COMMAND - 1;
+	}
+
+	void memory_count_notif(NotifInfo const *notif, bool allocated)
+	{
+		if (allocated) {
+			znotif_allocated[notifSlot(notif)]++;
+		} else {
+			znotif_freed[notifSlot(notif)]++;
+		}
+	}
+
+	void memory_count_node(bool allocated)
+	{
+		if (allocated) {
+			znodes_allocated++;
+		} else {
+			znodes_freed++;
+		}
+	}
+
+	static const char *notifSlotName(uint32 slot)
+	{
+		if (slot == NOTIF_SLOT_CONTROLLER_COMMAND) {
+			return "ControllerCommand";
+		}
+		switch (slot) {
+		case OpenZWave::Notification::Type_ValueAdded:                   return "ValueAdded";
+		case OpenZWave::Notification::Type_ValueRemoved:                 return "ValueRemoved";
+		case OpenZWave::Notification::Type_ValueChanged:                 return "ValueChanged";
+		case OpenZWave::Notification::Type_ValueRefreshed:               return "ValueRefreshed";
+		case OpenZWave::Notification::Type_Group:                        return "Group";
+		case OpenZWave::Notification::Type_NodeNew:                      return "NodeNew";
+		case OpenZWave::Notification::Type_NodeAdded:                    return "NodeAdded";
+		case OpenZWave::Notification::Type_NodeRemoved:                  return "NodeRemoved";
+		case OpenZWave::Notification::Type_NodeProtocolInfo:             return "NodeProtocolInfo";
+		case OpenZWave::Notification::Type_NodeNaming:                   return "NodeNaming";
+		case OpenZWave::Notification::Type_NodeEvent:                    return "NodeEvent";
+		case OpenZWave::Notification::Type_PollingDisabled:              return "PollingDisabled";
+		case OpenZWave::Notification::Type_PollingEnabled:               return "PollingEnabled";
+		case OpenZWave::Notification::Type_SceneEvent:                   return "SceneEvent";
+		case OpenZWave::Notification::Type_CreateButton:                 return "CreateButton";
+		case OpenZWave::Notification::Type_DeleteButton:                 return "DeleteButton";
+		case OpenZWave::Notification::Type_ButtonOn:                     return "ButtonOn";
+		case OpenZWave::Notification::Type_ButtonOff:                    return "ButtonOff";
+		case OpenZWave::Notification::Type_DriverReady:                  return "DriverReady";
+		case OpenZWave::Notification::Type_DriverFailed:                 return "DriverFailed";
+		case OpenZWave::Notification::Type_DriverReset:                  return "DriverReset";
+		case OpenZWave::Notification::Type_EssentialNodeQueriesComplete: return "EssentialNodeQueriesComplete";
+		case OpenZWave::Notification::Type_NodeQueriesComplete:          return "NodeQueriesComplete";
+		case OpenZWave::Notification::Type_AwakeNodesQueried:            return "AwakeNodesQueried";
+		case OpenZWave::Notification::Type_AllNodesQueriedSomeDead:      return "AllNodesQueriedSomeDead";
+		case OpenZWave::Notification::Type_AllNodesQueried:              return "AllNodesQueried";
+		case OpenZWave::Notification::Type_Notification:                 return "Notification";
+		case OpenZWave::Notification::Type_DriverRemoved:                return "DriverRemoved";
+#if OPENZWAVE_16
+		case OpenZWave::Notification::Type_NodeReset:                    return "NodeReset";
+		case OpenZWave::Notification::Type_UserAlerts:                   return "UserAlerts";
+		case OpenZWave::Notification::Type_ManufacturerSpecificDBReady:  return "ManufacturerSpecificDBReady";
+#endif
+		}
+		return NULL;
+	}
+
+	// heap bytes held by a string (none while it fits the small string buffer)
+	static uint64 stringBytes(::std::string const &str)
+	{
+		return (str.capacity() >= sizeof(::std::string)) ? str.capacity() + 1 : 0;
+	}
+
+	static uint64 notifBytes(NotifInfo const *notif)
+	{
+		return sizeof(NotifInfo) + stringBytes(notif->help) + stringBytes(notif->value.str)
+			+ notif->values.size() * (sizeof(OpenZWave::ValueID) + LIST_NODE_BYTES);
+	}
+
+	static uint64 nodeBytes(NodeInfo const *node)
+	{
+		NodeDescriptor const &desc = node->desc;
+		return sizeof(NodeInfo)
+			+ stringBytes(desc.manufacturer) + stringBytes(desc.manufacturerid)
+			+ stringBytes(desc.product) + stringBytes(desc.producttype) + stringBytes(desc.productid)
+			+ stringBytes(desc.type) + stringBytes(desc.name) + stringBytes(desc.loc)
+			+ (node->throttle ? sizeof(ThrottleInfo) + stringBytes(node->throttle->help) : 0);
+	}
+
+	typedef struct {
+		uint64 values;
+		uint64 value_bytes;
+		uint64 cached;
+		uint64 cached_bytes;
+		uint64 throttles;
+		uint64 throttle_bytes;
+		uint64 histories;
+		uint64 history_bytes;
+		uint64 meters;
+		uint64 meter_bytes;
+	} ValueUsage;
+
+	static void addValueUsage(ValueInfo const &vinfo, ValueUsage &u)
+	{
+		u.values++;
+		u.value_bytes += sizeof(ValueInfo) + LIST_NODE_BYTES
+			+ vinfo.bits.capacity() * sizeof(BitInfo)
+			+ vinfo.items.capacity() * sizeof(::std::string);
+		::std::vector< ::std::string >::const_iterator it;
+		for (it = vinfo.items.begin(); it != vinfo.items.end(); ++it) {
+			u.value_bytes += stringBytes(*it);
+		}
+		// shared with the snapshots holding on to it, counted once here
+		if (vinfo.cache) {
+			u.cached++;
+			u.cached_bytes += sizeof(CachedValue) + stringBytes(vinfo.cache->str);
+		}
+		if (vinfo.throttle) {
+			u.throttles++;
+			u.throttle_bytes += sizeof(ThrottleInfo) + stringBytes(vinfo.throttle->help);
+		}
+		if (vinfo.history) {
+			u.histories++;
+			u.history_bytes += sizeof(HistoryInfo)
+				+ (vinfo.history->timestamps.capacity() + vinfo.history->values.capacity()) * sizeof(double);
+		}
+		if (vinfo.meter) {
+			u.meters++;
+			u.meter_bytes += sizeof(MeterInfo);
+		}
+	}
+
+	static Local<Object> usageObject(uint64 count, uint64 bytes)
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Object> o = Nan::New<Object>();
+		AddNumberProp(o, count, (double) count);
+		AddNumberProp(o, bytes, (double) bytes);
+		return scope.Escape(o);
+	}
+
+	/*
+	* Where the addon's own memory goes: counts and (approximate) bytes of the
+	* node and value state, the notification queue, scenes, the controller
+	* command map, the string table and value table, plus the V8 persistent
+	* handles held. 'notifications' has the NotifInfo allocations per
+	* notification type (with their rate since the previous call), and
+	* 'nodes' the NodeInfo ones: live counts that keep growing point to leaks.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetMemoryStats)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		Local<Object> stats = Nan::New<Object>();
+
+		uint64 nodes = 0, node_bytes = 0;
+		ValueUsage vu = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		uint64 handles, handle_bytes;
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			NodeInfo *node;
+			::std::list<ValueInfo>::const_iterator vit;
+			for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+				if (!(node = get_node_info(nodeid))) {
+					continue;
+				}
+				nodes++;
+				node_bytes += nodeBytes(node);
+				for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+					addValueUsage(*vit, vu);
+				}
+			}
+			handles = zvalues.size();
+			handle_bytes = zvalues.capacity() * sizeof(ValueHandleSlot);
+		}
+		Local<Object> nobj = usageObject(nodes, node_bytes);
+		AddNumberProp(nobj, allocated, (double) znodes_allocated);
+		AddNumberProp(nobj, freed, (double) znodes_freed);
+		// removed, but not reclaimed yet (or leaked)
+		AddNumberProp(nobj, retired, (double) (znodes_allocated - znodes_freed - nodes));
+		Nan::Set(stats, Nan::New<String>("nodes").ToLocalChecked(), nobj);
+		Nan::Set(stats, Nan::New<String>("values").ToLocalChecked(), usageObject(vu.values, vu.value_bytes));
+		Nan::Set(stats, Nan::New<String>("cachedValues").ToLocalChecked(), usageObject(vu.cached, vu.cached_bytes));
+		Nan::Set(stats, Nan::New<String>("valueHandles").ToLocalChecked(), usageObject(handles, handle_bytes));
+		Nan::Set(stats, Nan::New<String>("throttles").ToLocalChecked(), usageObject(vu.throttles, vu.throttle_bytes));
+		Nan::Set(stats, Nan::New<String>("histories").ToLocalChecked(), usageObject(vu.histories, vu.history_bytes));
+		Nan::Set(stats, Nan::New<String>("meters").ToLocalChecked(), usageObject(vu.meters, vu.meter_bytes));
+
+		uint64 queued = 0, queue_bytes = 0;
+		{
+			mutex::scoped_lock sl(zqueue_mutex);
+			// std::queue has no iterators, go through a copy of the pointers
+			::std::queue<NotifInfo *> q(zqueue);
+			while (!q.empty()) {
+				queued++;
+				queue_bytes += notifBytes(q.front());
+				q.pop();
+			}
+		}
+		Nan::Set(stats, Nan::New<String>("queue").ToLocalChecked(), usageObject(queued, queue_bytes));
+
+		uint64 scenes = 0, scene_bytes = 0;
+		{
+			mutex::scoped_lock sl(zscenes_mutex);
+			::std::list<SceneInfo *>::const_iterator it;
+			for (it = zscenes.begin(); it != zscenes.end(); ++it) {
+				scenes++;
+				scene_bytes += sizeof(SceneInfo) + LIST_NODE_BYTES + stringBytes((*it)->label)
+					+ (*it)->values.size() * (sizeof(OpenZWave::ValueID) + LIST_NODE_BYTES);
+			}
+		}
+		Nan::Set(stats, Nan::New<String>("scenes").ToLocalChecked(), usageObject(scenes, scene_bytes));
+
+		uint64 commands = 0, command_bytes = 0;
+		if (ctrlCmdNames) {
+			CommandMap::const_iterator it;
+			for (it = ctrlCmdNames->begin(); it != ctrlCmdNames->end(); ++it) {
+				commands++;
+				command_bytes += sizeof(CommandMap::value_type) + sizeof(void *) + stringBytes(it->first);
+			}
+			command_bytes += ctrlCmdNames->bucket_count() * sizeof(void *);
+		}
+		Nan::Set(stats, Nan::New<String>("commandMap").ToLocalChecked(), usageObject(commands, command_bytes));
+
+		uint32 strings, string_handles;
+		uint64 string_bytes;
+		intern_table_usage(&strings, &string_bytes, &string_handles);
+		Nan::Set(stats, Nan::New<String>("strings").ToLocalChecked(), usageObject(strings, string_bytes));
+
+		uint32 vt_capacity = value_table_capacity();
+		Nan::Set(stats, Nan::New<String>("valueTable").ToLocalChecked(),
+			usageObject(vt_capacity, vt_capacity * (sizeof(double) + 2 * sizeof(uint32))));
+
+		// emit_cb, ctx_obj, the Snapshot constructor and template, the value table and interned strings
+		uint32 persistent = (emit_cb ? 1 : 0) + (ctx_obj.IsEmpty() ? 0 : 1)
+			+ (Snapshot::constructor.IsEmpty() ? 0 : 1) + (Snapshot::tmpl.IsEmpty() ? 0 : 1)
+			+ (vt_capacity ? 1 : 0) + string_handles;
+		AddIntegerProp(stats, persistentHandles, persistent);
+
+		double now = nowMsec();
+		double secs = (zlast_stats_ts > 0) ? (now - zlast_stats_ts) / 1000.0 : 0;
+		Local<Object> notifs = Nan::New<Object>();
+		for (uint32 slot = 0; slot < NOTIF_SLOTS; slot++) {
+			uint64 allocated = znotif_allocated[slot];
+			uint64 freed = znotif_freed[slot];
+			if (allocated == 0) {
+				continue;
+			}
+			Local<Object> o = Nan::New<Object>();
+			AddNumberProp(o, allocated, (double) allocated);
+			AddNumberProp(o, freed, (double) freed);
+			AddNumberProp(o, live, (double) (allocated - freed));
+			// allocations per second since the previous call
+			AddNumberProp(o, rate, (secs > 0) ? (allocated - zlast_allocated[slot]) / secs : 0);
+			zlast_allocated[slot] = allocated;
+			const char *name = notifSlotName(slot);
+			::std::string key = name ? ::std::string(name) : "Type" + ::std::to_string(slot);
+			Nan::Set(notifs, Nan::New<String>(key).ToLocalChecked(), o);
+		}
+		zlast_stats_ts = now;
+		Nan::Set(stats, Nan::New<String>("notifications").ToLocalChecked(), notifs);
+
+		info.GetReturnValue().Set(stats);
+	}
+}
@@ -0,0 +1,232 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <cctype>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+#define COMMAND_CLASS_METER 0x32
+
+namespace OZW {
+
+	// meter tracking is opt-in, see OZW::TrackMeters
+	static bool zmeters_enabled = false;
+	// don't emit change events of tracked meters
+	static bool zmeters_quiet = false;
+
+	/*
+	* Units of the Meter scales that accumulate (energy, volume, pulse
+	* counts), as OpenZWave 1.4 and 1.6 name them. The instantaneous ones
+	* (W, V, A, power factor...) and the 'Exporting' flag are left alone.
+	*/
+	static const char *accumulating_units[] = {
+		"kWh", "kVAh", "kVarh", "pulses", "pulse count",
+		"cubic meters", "cubic feet", "US gallons", "m3", "ft3", "gal", NULL
+	};
+
+	static bool sameUnits(::std::string const &a, const char *b)
+	{
+		size_t i = 0;
+		for (; (i < a.size()) && b[i]; i++) {
+			if (::tolower((unsigned char) a[i]) != ::tolower((unsigned char) b[i])) {
+				return false;
+			}
+		}
+		return (i == a.size()) && !b[i];
+	}
+
+	// whether a value is a Meter reading that counts up, judging by its units
+	static bool meter_accumulating(ValueInfo *vinfo)
+	{
+		if ((vinfo->id.GetCommandClassId() != COMMAND_CLASS_METER) || !vinfo->meta_cached) {
+			return false;
+		}
+		switch (vinfo->id.GetType()) {
+			case OpenZWave::ValueID::ValueType_Byte:
+			case OpenZWave::ValueID::ValueType_Short:
+			case OpenZWave::ValueID::ValueType_Int:
+			case OpenZWave::ValueID::ValueType_Decimal:
+				break;
+			default:
+				return false;
+		}
+		for (const char **u = accumulating_units; *u; u++) {
+			if (sameUnits(vinfo->units.str(), *u)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void meter_window_reset(MeterInfo *m, double now)
+	{
+		m->window_start   = now;
+		m->window_delta   = 0;
+		m->window_resets  = 0;
+		m->window_samples = 0;
+	}
+
+	/*
+	* Account for the current reading of a value, if it's an accumulating
+	* meter and meters are being tracked. The first reading just seeds the
+	* state. Needs the value's metadata cached (as after its 'value added').
+	* 'ts' is when the reading was reported, msec since the epoch.
+	*/
+	void meter_record(ValueInfo *vinfo, double ts)
+	{
+		double val;
+		if (!zmeters_enabled || !vinfo || !meter_accumulating(vinfo)
+			|| !cachedValueAsDouble(vinfo->id, vinfo->cache.get(), &val)) {
+			return;
+		}
+		MeterInfo *m = vinfo->meter;
+		if (!m) {
+			m = new MeterInfo();
+			m->last    = val;
+			m->last_ts = ts;
+			m->total_delta   = 0;
+			m->total_resets  = 0;
+			m->total_samples = 0;
+			meter_window_reset(m, ts);
+			vinfo->meter = m;
+			return;
+		}
+		double delta = val - m->last;
+		if (delta < 0) {
+			// the counter wrapped around or was reset: it restarted from 0
+			delta = val;
+			m->window_resets++;
+			m->total_resets++;
+		}
+		m->window_delta += delta;
+		m->total_delta  += delta;
+		m->window_samples++;
+		m->total_samples++;
+		m->last    = val;
+		m->last_ts = ts;
+	}
+
+	bool meter_quiet(ValueInfo *vinfo)
+	{
+		return zmeters_quiet && vinfo && vinfo->meter;
+	}
+
+	static bool getMeterArg(Local<Object> opts, const char *name, bool def)
+	{
+		Local<Value> v = Nan::Get(opts, Nan::New<String>(name).ToLocalChecked()).ToLocalChecked();
+		return v->IsBoolean() ? Nan::To<bool>(v).FromJust() : def;
+	}
+
+	/*
+	* Start (or stop) accumulating the readings of all Meter command class
+	* values that count up (energy, volume, pulses) natively. With
+	* 'suppressEvents' their change events are not emitted at all, and
+	* getMeterSummary() is to be polled instead. Instantaneous readings
+	* (power, voltage, current...) keep emitting as usual.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::TrackMeters)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "enable");
+		bool enable = Nan::To<bool>(info[0]).FromJust();
+		bool quiet = false;
+		if ((info.Length() > 1) && info[1]->IsObject()) {
+			Local<Object> opts = Nan::To<Object>(info[1]).ToLocalChecked();
+			quiet = getMeterArg(opts, "suppressEvents", false);
+		}
+		// when the current readings were reported isn't kept, so they're seeded as of now
+		double now = nowMsec();
+		NodeInfo *node;
+		::std::list<ValueInfo>::iterator vit;
+		mutex::scoped_lock sl(znodes_mutex);
+		zmeters_enabled = enable;
+		zmeters_quiet = enable && quiet;
+		for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+			if (!(node = get_node_info(nodeid))) {
+				continue;
+			}
+			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+				if (enable) {
+					// seeds the ones not tracked yet
+					if (!vit->meter) {
+						meter_record(&*vit, now);
+					}
+				} else {
+					delete vit->meter;
+					vit->meter = NULL;
+				}
+			}
+		}
+	}
+
+	/*
+	* Get the accumulated readings of all tracked meters, keyed by value_id:
+	* the delta, counter resets, number of reports and average rate (per hour)
+	* of the current window, and the totals since tracking started.
+	* Starts a new window, unless called with false.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetMeterSummary)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		bool reset = true;
+		if ((info.Length() > 0) && info[0]->IsBoolean()) {
+			reset = Nan::To<bool>(info[0]).FromJust();
+		}
+		double now = nowMsec();
+		Local<Object> summary = Nan::New<Object>();
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			NodeInfo *node;
+			::std::list<ValueInfo>::iterator vit;
+			for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+				if (!(node = get_node_info(nodeid))) {
+					continue;
+				}
+				for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+					MeterInfo *m = vit->meter;
+					if (!m) {
+						continue;
+					}
+					double hours = (now - m->window_start) / 3600000.0;
+					Local<Object> mobj = Nan::New<Object>();
+					AddNumberProp(mobj, value, m->last);
+					AddNumberProp(mobj, timestamp, m->last_ts);
+					AddNumberProp(mobj, since, m->window_start);
+					AddNumberProp(mobj, delta, m->window_delta);
+					AddNumberProp(mobj, rate, (hours > 0) ? m->window_delta / hours : 0);
+					AddIntegerProp(mobj, resets, m->window_resets);
+					AddIntegerProp(mobj, samples, m->window_samples);
+					AddNumberProp(mobj, totalDelta, m->total_delta);
+					AddIntegerProp(mobj, totalResets, m->total_resets);
+					AddIntegerProp(mobj, totalSamples, m->total_samples);
+					Nan::Set(summary,
+						Nan::New<String>(getValueIdDescriptor(vit->id)).ToLocalChecked(),
+						mobj);
+					if (reset) {
+						meter_window_reset(m, now);
+					}
+				}
+			}
+		}
+		info.GetReturnValue().Set(summary);
+	}
+}
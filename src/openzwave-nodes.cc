@@ -56,10 +56,45 @@ namespace OZW {
 		uint8 nodeid = Nan::To<Integer>(info[0]).ToLocalChecked()->Value();
 		uint8 commClass  = Nan::To<Integer>(info[1]).ToLocalChecked()->Value();
 		uint8 commClassVersion = 0;
-		OZWManager( GetNodeClassInformation, homeid, nodeid, commClass, NULL, &commClassVersion);
+		NodeDescriptor *desc = get_node_classes(nodeid);
+		if (desc) {
+			commClassVersion = desc->class_versions[commClass];
+		} else {
+			OZWManager( GetNodeClassInformation, homeid, nodeid, commClass, NULL, &commClassVersion);
+		}
 		info.GetReturnValue().Set(Nan::New<Integer>(commClassVersion));
 	}
 
+	/*
+	* Gets all the Command Classes supported by a node, with their names and
+	* versions, in one call. Undefined for unknown nodes.
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::GetNodeCommandClasses)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "nodeid");
+		uint8 nodeid = Nan::To<Integer>(info[0]).ToLocalChecked()->Value();
+		NodeDescriptor *desc = get_node_classes(nodeid);
+		if (!desc) {
+			return;
+		}
+		Local<Array> classes = Nan::New<Array>();
+		uint32 idx = 0;
+		for (uint32 cc = 0; cc < 256; cc++) {
+			if (!(desc->class_bits[cc >> 5] & (1u << (cc & 31)))) {
+				continue;
+			}
+			Local<Object> o = Nan::New<Object>();
+			AddIntegerProp(o, class_id, cc);
+			AddStringProp(o, name, get_class_name(cc).c_str());
+			AddIntegerProp(o, version, desc->class_versions[cc]);
+			Nan::Set(classes, idx++, o);
+		}
+		info.GetReturnValue().Set(classes);
+	}
+
 #ifdef OPENZWAVE16_DEPRECATED
 	// =================================================================
 	NAN_METHOD(OZW::SetNodeOn)
@@ -166,6 +201,10 @@ namespace OZW {
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string location(*Nan::Utf8String( info[1] ));
 		OZWManager( SetNodeLocation, homeid, nodeid, location);
+		NodeInfo *node = get_node_info(nodeid);
+		if (node && node->desc.names_valid) {
+			node->desc.loc = location;
+		}
 	}
 
 	/*
@@ -180,6 +219,10 @@ namespace OZW {
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string name(*Nan::Utf8String( info[1] ));
 		OZWManager( SetNodeName, homeid, nodeid, name);
+		NodeInfo *node = get_node_info(nodeid);
+		if (node && node->desc.names_valid) {
+			node->desc.name = name;
+		}
 	}
 
 	/*
@@ -213,7 +256,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result,  GetNodeManufacturerName, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->manufacturer;
+		} else {
+			OZWManagerAssign(result,  GetNodeManufacturerName, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -258,7 +306,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		bool result = false;
-		OZWManagerAssign(result,  IsNodeListeningDevice, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->listening;
+		} else {
+			OZWManagerAssign(result,  IsNodeListeningDevice, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 
@@ -273,7 +326,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		bool result = false;
-		OZWManagerAssign(result,  IsNodeFrequentListeningDevice, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->frequent_listening;
+		} else {
+			OZWManagerAssign(result,  IsNodeFrequentListeningDevice, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 
@@ -288,7 +346,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		bool result = false;
-		OZWManagerAssign(result,  IsNodeBeamingDevice, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->beaming;
+		} else {
+			OZWManagerAssign(result,  IsNodeBeamingDevice, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 
@@ -303,7 +366,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		bool result = false;
-		OZWManagerAssign(result,  IsNodeRoutingDevice, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->routing;
+		} else {
+			OZWManagerAssign(result,  IsNodeRoutingDevice, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 
@@ -318,7 +386,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		bool result = false;
-		OZWManagerAssign(result,  IsNodeSecurityDevice, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->security_device;
+		} else {
+			OZWManagerAssign(result,  IsNodeSecurityDevice, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 
@@ -392,6 +465,31 @@ namespace OZW {
 		uint16 result = OpenZWave::Manager::Get()->GetNodeDeviceType(homeid, nodeid);
 		info.GetReturnValue().Set(Nan::New<Integer>(result));
 	}
+	/*
+	* Whether a node is failed / awake, as tracked from the notifications
+	* (see openzwave-liveness.cc). OpenZWave is only asked until the node's
+	* status is known.
+	*/
+	static bool nodeFailed(uint32 homeid, uint8 nodeid)
+	{
+		uint8 liveness = get_node_liveness(nodeid);
+		bool result = (liveness == NodeLiveness_Dead);
+		if (liveness == NodeLiveness_Unknown) {
+			OZWManagerAssign(result, IsNodeFailed, homeid, nodeid);
+		}
+		return result;
+	}
+
+	static bool nodeAwake(uint32 homeid, uint8 nodeid)
+	{
+		uint8 liveness = get_node_liveness(nodeid);
+		bool result = (liveness == NodeLiveness_Alive) || (liveness == NodeLiveness_Awake);
+		if (liveness == NodeLiveness_Unknown) {
+			OZWManagerAssign(result, IsNodeAwake, homeid, nodeid);
+		}
+		return result;
+	}
+
 	/*
 	 *
 	 */// ===================================================================
@@ -401,7 +499,7 @@ namespace OZW {
 		Nan::HandleScope scope;
 		CheckMinArgs(1, "nodeid");
 		uint8  nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
-		bool result = OpenZWave::Manager::Get()->IsNodeFailed(homeid, nodeid);
+		bool result = nodeFailed(homeid, nodeid);
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 	/*
@@ -413,7 +511,7 @@ namespace OZW {
 		Nan::HandleScope scope;
 		CheckMinArgs(1, "nodeid");
 		uint8  nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
-		bool result = OpenZWave::Manager::Get()->IsNodeAwake(homeid, nodeid);
+		bool result = nodeAwake(homeid, nodeid);
 		info.GetReturnValue().Set(Nan::New<Boolean>(result));
 	}
 	/*
@@ -452,7 +550,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		uint32 result = -1;
-		OZWManagerAssign(result,  GetNodeMaxBaudRate, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->max_baud_rate;
+		} else {
+			OZWManagerAssign(result,  GetNodeMaxBaudRate, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Uint32>(result));
 	}
 
@@ -467,7 +570,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		uint8 result = -1;
-		OZWManagerAssign(result,  GetNodeVersion, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->version;
+		} else {
+			OZWManagerAssign(result,  GetNodeVersion, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Integer>(result));
 	}
 
@@ -482,7 +590,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		uint8 result = -1;
-		OZWManagerAssign(result,  GetNodeSecurity, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->security;
+		} else {
+			OZWManagerAssign(result,  GetNodeSecurity, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Integer>(result));
 	}
 
@@ -497,7 +610,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		uint8 result = -1;
-		OZWManagerAssign(result,  GetNodeBasic, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->basic;
+		} else {
+			OZWManagerAssign(result,  GetNodeBasic, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Integer>(result));
 	}
 
@@ -512,7 +630,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		uint8 result = -1;
-		OZWManagerAssign(result,  GetNodeGeneric, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->generic;
+		} else {
+			OZWManagerAssign(result,  GetNodeGeneric, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Integer>(result));
 	}
 
@@ -527,7 +650,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		uint8 result = -1;
-		OZWManagerAssign(result, GetNodeSpecific, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+		if (desc) {
+			result = desc->specific;
+		} else {
+			OZWManagerAssign(result, GetNodeSpecific, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<Integer>(result));
 	}
 
@@ -542,7 +670,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result,  GetNodeType, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->type;
+		} else {
+			OZWManagerAssign(result,  GetNodeType, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -557,7 +690,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result, GetNodeProductName, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->product;
+		} else {
+			OZWManagerAssign(result, GetNodeProductName, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -572,7 +710,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result, GetNodeName, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->name;
+		} else {
+			OZWManagerAssign(result, GetNodeName, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -587,7 +730,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result, GetNodeLocation, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->loc;
+		} else {
+			OZWManagerAssign(result, GetNodeLocation, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -602,7 +750,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result, GetNodeManufacturerId, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->manufacturerid;
+		} else {
+			OZWManagerAssign(result, GetNodeManufacturerId, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -617,7 +770,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result, GetNodeProductType, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->producttype;
+		} else {
+			OZWManagerAssign(result, GetNodeProductType, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -632,7 +790,12 @@ namespace OZW {
 		CheckMinArgs(1, "nodeid");
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string result("");
-		OZWManagerAssign(result, GetNodeProductId, homeid, nodeid);
+		NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+		if (desc) {
+			result = desc->productid;
+		} else {
+			OZWManagerAssign(result, GetNodeProductId, homeid, nodeid);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
@@ -648,6 +811,10 @@ namespace OZW {
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string name(*Nan::Utf8String( info[1] ));
 		OZWManager( SetNodeManufacturerName, homeid, nodeid, name);
+		NodeInfo *node = get_node_info(nodeid);
+		if (node && node->desc.names_valid) {
+			node->desc.manufacturer = name;
+		}
 	}
 
 	/*
@@ -662,6 +829,10 @@ namespace OZW {
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		::std::string name(*Nan::Utf8String( info[1] ));
 		OZWManager( SetNodeProductName, homeid, nodeid, name);
+		NodeInfo *node = get_node_info(nodeid);
+		if (node && node->desc.names_valid) {
+			node->desc.product = name;
+		}
 	}
 
 #if OPENZWAVE_16
@@ -677,10 +848,65 @@ namespace OZW {
 		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
 		OpenZWave::Node::MetaDataFields metadata = static_cast<OpenZWave::Node::MetaDataFields>(Nan::To<int>(info[1]).ToChecked());
 		::std::string result("");
-		OZWManagerAssign(result, GetMetaData, homeid, nodeid, metadata);
+		NodeDescriptor *desc = get_node_metadata(nodeid);
+		if (desc && (metadata < NODE_METADATA_FIELDS)) {
+			result = desc->metadata[metadata];
+		} else {
+			OZWManagerAssign(result, GetMetaData, homeid, nodeid, metadata);
+		}
 		info.GetReturnValue().Set(Nan::New<String>(result.c_str()).ToLocalChecked());
 	}
 
+	// the keys of getAllMetaData(), as in the MetaDataFields enum
+	static const char *metadata_field_names[NODE_METADATA_FIELDS] = {
+		"OzwInfoPage_URL", "ZWProductPage_URL", "ProductPic", "Description",
+		"ProductManual_URL", "ProductPage_URL", "InclusionHelp", "ExclusionHelp",
+		"ResetHelp", "WakeupHelp", "ProductSupport_URL", "Frequency",
+		"Name", "Identifier"
+	};
+
+	static Local<Object> metadata2v8Object(uint8 nodeid, NodeDescriptor const *desc)
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Object> o = Nan::New<Object>();
+		AddIntegerProp(o, node_id, nodeid);
+		for (uint32 field = 0; field < NODE_METADATA_FIELDS; field++) {
+			Nan::Set(o, Nan::New<String>(metadata_field_names[field]).ToLocalChecked(),
+				Nan::New<String>(desc->metadata[field]).ToLocalChecked());
+		}
+		return scope.Escape(o);
+	}
+
+	/*
+	* Get all the device database metadata of a node in one call, keyed
+	* as in MetaDataFields (undefined for unknown nodes), or without a
+	* node id an array of it for all known nodes. Until the database is
+	* ready there's none: undefined, or an empty array.
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::GetAllMetaData)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		if ((info.Length() > 0) && info[0]->IsNumber()) {
+			uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
+			NodeDescriptor *desc = get_node_metadata(nodeid);
+			if (desc) {
+				info.GetReturnValue().Set(metadata2v8Object(nodeid, desc));
+			}
+			return;
+		}
+		Local<Array> all = Nan::New<Array>();
+		uint32 idx = 0;
+		for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+			NodeDescriptor *desc = get_node_metadata(nodeid);
+			if (desc) {
+				Nan::Set(all, idx++, metadata2v8Object(nodeid, desc));
+			}
+		}
+		info.GetReturnValue().Set(all);
+	}
+
 	/*
 	 *
 	 */
@@ -705,4 +931,154 @@ namespace OZW {
 	}
 #endif
 
+	/*
+	* A node as a JS object, with the properties selected by the NodeFields
+	* mask. The shape only depends on the mask, missing info is zeroed.
+	*/
+	static Local<Object> node2v8Object(NodeInfo *node, uint32 fields)
+	{
+		Nan::EscapableHandleScope scope;
+		uint8 nodeid = node->nodeid;
+		NodeDescriptor nodesc = NodeDescriptor();
+		Local<Object> nodeobj = Nan::New<Object>();
+		AddIntegerProp(nodeobj, node_id, nodeid);
+		if (fields & NodeField_Names) {
+			populateNode(nodeobj, node->homeid, nodeid);
+		}
+		if (fields & NodeField_Protocol) {
+			NodeDescriptor *desc = get_node_descriptor(nodeid, true);
+			if (!desc) {
+				desc = &nodesc;
+			}
+			AddBooleanProp(nodeobj, listening, desc->listening);
+			AddBooleanProp(nodeobj, frequent_listening, desc->frequent_listening);
+			AddBooleanProp(nodeobj, beaming, desc->beaming);
+			AddBooleanProp(nodeobj, routing, desc->routing);
+			AddBooleanProp(nodeobj, security_device, desc->security_device);
+			AddNumberProp(nodeobj, max_baud_rate, desc->max_baud_rate);
+			AddIntegerProp(nodeobj, version, desc->version);
+			AddIntegerProp(nodeobj, security, desc->security);
+			AddIntegerProp(nodeobj, basic, desc->basic);
+			AddIntegerProp(nodeobj, generic, desc->generic);
+			AddIntegerProp(nodeobj, specific, desc->specific);
+		}
+		// OpenZWave doesn't know about stale (warm start) nodes yet
+		bool live = !node->stale;
+		if (fields & NodeField_Type) {
+			uint16 device_type = 0, plus_type = 0;
+			uint8 role = 0;
+			::std::string device_type_string, role_string, plus_type_string;
+			if (live) {
+				OZWManagerAssign(device_type, GetNodeDeviceType, node->homeid, nodeid);
+				OZWManagerAssign(device_type_string, GetNodeDeviceTypeString, node->homeid, nodeid);
+				OZWManagerAssign(role, GetNodeRole, node->homeid, nodeid);
+				OZWManagerAssign(role_string, GetNodeRoleString, node->homeid, nodeid);
+				OZWManagerAssign(plus_type, GetNodePlusType, node->homeid, nodeid);
+				OZWManagerAssign(plus_type_string, GetNodePlusTypeString, node->homeid, nodeid);
+			}
+			AddIntegerProp(nodeobj, device_type, device_type);
+			AddStringProp(nodeobj, device_type_string, device_type_string.c_str());
+			AddIntegerProp(nodeobj, role, role);
+			AddStringProp(nodeobj, role_string, role_string.c_str());
+			AddIntegerProp(nodeobj, plus_type, plus_type);
+			AddStringProp(nodeobj, plus_type_string, plus_type_string.c_str());
+		}
+		if (fields & NodeField_Status) {
+			bool failed = false, awake = false, info_received = false;
+			::std::string query_stage;
+			if (live) {
+				failed = nodeFailed(node->homeid, nodeid);
+				awake = nodeAwake(node->homeid, nodeid);
+				OZWManagerAssign(info_received, IsNodeInfoReceived, node->homeid, nodeid);
+				OZWManagerAssign(query_stage, GetNodeQueryStage, node->homeid, nodeid);
+			}
+			AddBooleanProp(nodeobj, failed, failed);
+			AddBooleanProp(nodeobj, awake, awake);
+			AddBooleanProp(nodeobj, info_received, info_received);
+			AddStringProp(nodeobj, query_stage, query_stage.c_str());
+			AddBooleanProp(nodeobj, polled, node->polled);
+			AddBooleanProp(nodeobj, stale, node->stale);
+		}
+		return scope.Escape(nodeobj);
+	}
+
+	static uint32 getNodeFieldsArg(const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 offset)
+	{
+		if ((info.Length() > offset) && info[offset]->IsNumber()) {
+			return Nan::To<uint32_t>(info[offset]).FromJust();
+		}
+		return NodeField_All;
+	}
+
+	/*
+	* Get everything known about a node in one call, with the properties
+	* selected by an optional NodeFields mask. Undefined for unknown nodes.
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::GetNodeInfo)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "nodeid");
+		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
+		uint32 fields = getNodeFieldsArg(info, 1);
+		NodeInfo *node = get_node_info(nodeid);
+		if (node) {
+			info.GetReturnValue().Set(node2v8Object(node, fields));
+		}
+	}
+
+	/*
+	* Resolve a node id into an opaque handle to the node as it is now.
+	* Once the node is removed, or reset and included again, the handle no
+	* longer resolves, even if the node id gets reused.
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::ResolveNode)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "nodeid");
+		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
+		NodeInfo *node = get_node_info(nodeid);
+		if (node) {
+			info.GetReturnValue().Set(Nan::New<Uint32>(get_node_handle(node)));
+		}
+	}
+
+	/*
+	* As getNodeInfo(), by node handle. Undefined for stale handles.
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::GetNodeInfoByHandle)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "handle");
+		uint32 fields = getNodeFieldsArg(info, 1);
+		NodeInfo *node = get_node_by_handle(Nan::To<uint32_t>(info[0]).FromJust());
+		if (node) {
+			info.GetReturnValue().Set(node2v8Object(node, fields));
+		}
+	}
+
+	/*
+	* Get all known nodes in one call, as in getNodeInfo()
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::GetNodes)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		uint32 fields = getNodeFieldsArg(info, 0);
+		Local<Array> nodes = Nan::New<Array>();
+		uint32 idx = 0;
+		for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+			NodeInfo *node = get_node_info(nodeid);
+			if (node) {
+				Nan::Set(nodes, idx++, node2v8Object(node, fields));
+			}
+		}
+		info.GetReturnValue().Set(nodes);
+	}
 }
@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	static const char *driver_stage_names[DriverStage_Count] = {
+		"connect", "driverReady", "awakeNodesQueried", "allNodesQueried"
+	};
+	static const char *node_stage_names[NodeStage_Count] = {
+		"added", "protocolInfo", "essentialQueriesComplete", "queriesComplete"
+	};
+
+	/*
+	* When each startup milestone was reached, msec since the epoch (0 if
+	* not yet). Indexed by node id, so it outlives the NodeInfo of a node
+	* that gets re-added. Only accessed on the V8 thread.
+	*/
+	static double zdriver_stages[DriverStage_Count];
+	static double znode_stages[NODE_SLOTS][NodeStage_Count];
+
+	void profile_driver_stage(uint8 stage, double ts)
+	{
+		if (stage == DriverStage_Connect) {
+			// a new startup
+			memset(zdriver_stages, 0, sizeof(zdriver_stages));
+			memset(znode_stages, 0, sizeof(znode_stages));
+		}
+		// only the first time round counts
+		if (zdriver_stages[stage] == 0) {
+			zdriver_stages[stage] = ts;
+		}
+	}
+
+	void profile_node_stage(uint8 nodeid, uint8 stage, double ts)
+	{
+		if (stage == NodeStage_Added) {
+			// (re)added nodes go through their interview again
+			memset(znode_stages[nodeid], 0, sizeof(znode_stages[nodeid]));
+		}
+		if (znode_stages[nodeid][stage] == 0) {
+			znode_stages[nodeid][stage] = ts;
+		}
+	}
+
+	typedef struct {
+		uint8  nodeid;
+		double total;
+	} NodeProfileOrder;
+
+	static bool slowerNode(NodeProfileOrder const &a, NodeProfileOrder const &b)
+	{
+		return a.total > b.total;
+	}
+
+	/*
+	* The startup timeline: when the driver reached each milestone, and per
+	* node when each interview stage completed and how long it took (since
+	* the previous stage, or since the driver got ready for the first one).
+	* Nodes are ordered by their total interview time, slowest first; the
+	* ones still being interviewed count up to now.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetStartupProfile)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		double now = nowMsec();
+		double origin = zdriver_stages[DriverStage_DriverReady] ?
+			zdriver_stages[DriverStage_DriverReady] : zdriver_stages[DriverStage_Connect];
+
+		Local<Object> profile = Nan::New<Object>();
+		Local<Object> driver = Nan::New<Object>();
+		for (uint8 stage = 0; stage < DriverStage_Count; stage++) {
+			if (zdriver_stages[stage] > 0) {
+				Nan::Set(driver, Nan::New<String>(driver_stage_names[stage]).ToLocalChecked(),
+					Nan::New<Number>(zdriver_stages[stage]));
+			}
+		}
+		if (zdriver_stages[DriverStage_Connect] > 0) {
+			double end = zdriver_stages[DriverStage_AllNodesQueried] ?
+				zdriver_stages[DriverStage_AllNodesQueried] : now;
+			AddNumberProp(driver, elapsed, end - zdriver_stages[DriverStage_Connect]);
+		}
+		Nan::Set(profile, Nan::New<String>("driver").ToLocalChecked(), driver);
+
+		::std::vector<NodeProfileOrder> order;
+		for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+			double *stages = znode_stages[nodeid];
+			if (stages[NodeStage_Added] == 0) {
+				continue;
+			}
+			double end = stages[NodeStage_QueriesComplete] ? stages[NodeStage_QueriesComplete] : now;
+			NodeProfileOrder o = { (uint8) nodeid, end - stages[NodeStage_Added] };
+			order.push_back(o);
+		}
+		::std::stable_sort(order.begin(), order.end(), slowerNode);
+
+		Local<Array> nodes = Nan::New<Array>(order.size());
+		for (uint32 i = 0; i < order.size(); i++) {
+			double *stages = znode_stages[order[i].nodeid];
+			Local<Object> nobj = Nan::New<Object>();
+			Local<Object> durations = Nan::New<Object>();
+			AddIntegerProp(nobj, node_id, order[i].nodeid);
+			double prev = origin ? ::std::min(origin, stages[NodeStage_Added]) : stages[NodeStage_Added];
+			int slowest = -1;
+			double slowest_msec = 0;
+			for (uint8 stage = 0; stage < NodeStage_Count; stage++) {
+				if (stages[stage] == 0) {
+					continue;
+				}
+				double msec = stages[stage] - prev;
+				Local<String> name = Nan::New<String>(node_stage_names[stage]).ToLocalChecked();
+				Nan::Set(nobj, name, Nan::New<Number>(stages[stage]));
+				Nan::Set(durations, name, Nan::New<Number>(msec));
+				if ((slowest < 0) || (msec > slowest_msec)) {
+					slowest = stage;
+					slowest_msec = msec;
+				}
+				prev = stages[stage];
+			}
+			Nan::Set(nobj, Nan::New<String>("durations").ToLocalChecked(), durations);
+			AddStringProp(nobj, slowestStage, node_stage_names[slowest]);
+			AddNumberProp(nobj, slowestMsec, slowest_msec);
+			AddNumberProp(nobj, total, order[i].total);
+			AddBooleanProp(nobj, complete, stages[NodeStage_QueriesComplete] > 0);
+			Nan::Set(nodes, i, nobj);
+		}
+		Nan::Set(profile, Nan::New<String>("nodes").ToLocalChecked(), nodes);
+		info.GetReturnValue().Set(profile);
+	}
+}
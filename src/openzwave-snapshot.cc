@@ -0,0 +1,186 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	Nan::Persistent<v8::Function> Snapshot::constructor;
+	Nan::Persistent<v8::FunctionTemplate> Snapshot::tmpl;
+
+	void Snapshot::Init()
+	{
+		Local<FunctionTemplate> t = Nan::New<FunctionTemplate>(Snapshot::New);
+		t->SetClassName(Nan::New("Snapshot").ToLocalChecked());
+		t->InstanceTemplate()->SetInternalFieldCount(1);
+		Nan::SetPrototypeMethod(t, "getNodeIds", Snapshot::GetNodeIds);
+		Nan::SetPrototypeMethod(t, "getValues", Snapshot::GetValues);
+		Nan::SetPrototypeMethod(t, "toJSON", Snapshot::ToJSON);
+		tmpl.Reset(t);
+		constructor.Reset(Nan::GetFunction(t).ToLocalChecked());
+	}
+
+	Local<Object> Snapshot::NewInstance()
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Function> cons = Nan::New(constructor);
+		return scope.Escape(Nan::NewInstance(cons).ToLocalChecked());
+	}
+
+	// ===================================================================
+	NAN_METHOD(Snapshot::New)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		Snapshot* self = new Snapshot();
+		self->seq = 0;
+		self->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+	}
+
+	// the Snapshot a method got called on, NULL (and throws) if it isn't one
+	static Snapshot *unwrapSnapshot(Local<Object> receiver)
+	{
+		if (!Nan::New(Snapshot::tmpl)->HasInstance(receiver)) {
+			Nan::ThrowTypeError("not a Snapshot");
+			return NULL;
+		}
+		return ObjectWrap::Unwrap<Snapshot>(receiver);
+	}
+
+	// a snapshot value as a JS object, like the 'value added' ones minus the metadata
+	static Local<Object> snapshotValue2v8Value(SnapshotValue const &sv)
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Object> valobj = Nan::New<Object>();
+		populateValueId(valobj, sv.id, ValueField_Id);
+		Nan::Set(valobj, Nan::New<String>("value").ToLocalChecked(),
+			cachedValue2v8Value(sv.id, sv.value.get()));
+		return scope.Escape(valobj);
+	}
+
+	static Local<Array> snapshotValues(Snapshot *self, int nodeid)
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Array> values = Nan::New<Array>();
+		uint32 idx = 0;
+		::std::vector<SnapshotValue>::const_iterator vit;
+		for (vit = self->values.begin(); vit != self->values.end(); ++vit) {
+			if ((nodeid < 0) || (vit->id.GetNodeId() == nodeid)) {
+				Nan::Set(values, idx++, snapshotValue2v8Value(*vit));
+			}
+		}
+		return scope.Escape(values);
+	}
+
+	/*
+	* The ids of all the nodes in the snapshot
+	*/
+	// ===================================================================
+	NAN_METHOD(Snapshot::GetNodeIds)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		Snapshot* self = unwrapSnapshot(info.This());
+		if (!self) {
+			return;
+		}
+		Local<Array> nodeids = Nan::New<Array>(self->nodeids.size());
+		for (unsigned int i = 0; i < self->nodeids.size(); i++) {
+			Nan::Set(nodeids, i, Nan::New<Integer>(self->nodeids[i]));
+		}
+		info.GetReturnValue().Set(nodeids);
+	}
+
+	/*
+	* The values in the snapshot, either all of them or of a single node
+	*/
+	// ===================================================================
+	NAN_METHOD(Snapshot::GetValues)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		Snapshot* self = unwrapSnapshot(info.This());
+		if (!self) {
+			return;
+		}
+		int nodeid = -1;
+		if ((info.Length() > 0) && info[0]->IsNumber()) {
+			nodeid = Nan::To<int32_t>(info[0]).FromJust();
+		}
+		info.GetReturnValue().Set(snapshotValues(self, nodeid));
+	}
+
+	/*
+	* So that JSON.stringify(snapshot) serializes it as a whole
+	*/
+	// ===================================================================
+	NAN_METHOD(Snapshot::ToJSON)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		Snapshot* self = unwrapSnapshot(info.This());
+		if (!self) {
+			return;
+		}
+		Local<Object> o = Nan::New<Object>();
+		AddNumberProp(o, seq, (double) self->seq);
+		Nan::Set(o, Nan::New<String>("values").ToLocalChecked(), snapshotValues(self, -1));
+		info.GetReturnValue().Set(o);
+	}
+
+	/*
+	* Take a consistent snapshot of all nodes and values. For every value
+	* this copies its ValueID and takes a reference on its cached contents
+	* (which the live state replaces, never modifies, on updates), so it's
+	* O(values) with znodes_mutex held, but no contents get copied.
+	*/
+	Local<Object> Snapshot::Take()
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Object> snapobj = Snapshot::NewInstance();
+		Snapshot* snap = ObjectWrap::Unwrap<Snapshot>(snapobj);
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			snap->seq = get_value_seq();
+			NodeInfo *node;
+			::std::list<ValueInfo>::iterator vit;
+			for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+				if (!(node = get_node_info(nodeid))) {
+					continue;
+				}
+				snap->nodeids.push_back(nodeid);
+				for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+					SnapshotValue sv = { vit->id, vit->cache };
+					snap->values.push_back(sv);
+				}
+			}
+		}
+		AddNumberProp(snapobj, seq, (double) snap->seq);
+		return scope.Escape(snapobj);
+	}
+
+	// ===================================================================
+	NAN_METHOD(OZW::TakeSnapshot)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		info.GetReturnValue().Set(Snapshot::Take());
+	}
+}
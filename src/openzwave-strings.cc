@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <unordered_map>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	struct InternEntry {
+		const ::std::string *str;  // the key of its slot in zstrings
+		uint32 refs;
+		Nan::Persistent<v8::String> v8str;  // created on first use
+	};
+
+	/*
+	* The intern table. Being node based, its entries never move, so
+	* InternedStrings can point to them. Also keeps the byte counts of
+	* what's stored, and of what would be without interning.
+	*/
+	static ::std::unordered_map< ::std::string, InternEntry > zstrings;
+	static uint64 zstrings_refs = 0;
+	static uint64 zstrings_bytes = 0;
+	static uint64 zstrings_ref_bytes = 0;
+
+	static const ::std::string empty_string;
+
+	static void intern_ref(InternEntry *entry)
+	{
+		if (entry) {
+			entry->refs++;
+			zstrings_refs++;
+			zstrings_ref_bytes += entry->str->size();
+		}
+	}
+
+	static void intern_unref(InternEntry *entry)
+	{
+		if (!entry) {
+			return;
+		}
+		zstrings_refs--;
+		zstrings_ref_bytes -= entry->str->size();
+		if (--entry->refs == 0) {
+			zstrings_bytes -= entry->str->size();
+			entry->v8str.Reset();
+			zstrings.erase(*entry->str);
+		}
+	}
+
+	InternedString::InternedString(::std::string const &str)
+	{
+		::std::pair< ::std::unordered_map< ::std::string, InternEntry >::iterator, bool > res =
+			zstrings.emplace(::std::piecewise_construct, ::std::forward_as_tuple(str), ::std::forward_as_tuple());
+		entry = &res.first->second;
+		if (res.second) {
+			entry->str = &res.first->first;
+			entry->refs = 0;
+			zstrings_bytes += str.size();
+		}
+		intern_ref(entry);
+	}
+
+	InternedString::InternedString(InternedString const &other) : entry(other.entry)
+	{
+		intern_ref(entry);
+	}
+
+	InternedString &InternedString::operator=(InternedString const &other)
+	{
+		if (entry != other.entry) {
+			intern_unref(entry);
+			entry = other.entry;
+			intern_ref(entry);
+		}
+		return *this;
+	}
+
+	InternedString::~InternedString()
+	{
+		intern_unref(entry);
+	}
+
+	::std::string const &InternedString::str() const
+	{
+		return entry ? *entry->str : empty_string;
+	}
+
+	Local<v8::String> InternedString::v8str() const
+	{
+		Nan::EscapableHandleScope scope;
+		if (!entry) {
+			return scope.Escape(Nan::EmptyString());
+		}
+		if (entry->v8str.IsEmpty()) {
+			entry->v8str.Reset(Nan::New<v8::String>(*entry->str).ToLocalChecked());
+		}
+		return scope.Escape(Nan::New(entry->v8str));
+	}
+
+	// for OZW::GetMemoryStats: the table's size, and its materialized V8 strings
+	void intern_table_usage(uint32 *strings, uint64 *bytes, uint32 *v8handles)
+	{
+		*strings = zstrings.size();
+		*bytes = zstrings_bytes + zstrings.size() * (sizeof(InternEntry) + sizeof(::std::string) + 2 * sizeof(void *));
+		*v8handles = 0;
+		::std::unordered_map< ::std::string, InternEntry >::const_iterator it;
+		for (it = zstrings.begin(); it != zstrings.end(); ++it) {
+			if (!it->second.v8str.IsEmpty()) {
+				(*v8handles)++;
+			}
+		}
+	}
+
+	/*
+	* Get the size of the intern table of value metadata strings, and the
+	* bytes saved by it.
+	* Returns { strings, references, bytes, bytesSaved }
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetStringTableStats)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		Local<Object> stats = Nan::New<Object>();
+		AddNumberProp(stats, strings, (double) zstrings.size());
+		AddNumberProp(stats, references, (double) zstrings_refs);
+		AddNumberProp(stats, bytes, (double) zstrings_bytes);
+		AddNumberProp(stats, bytesSaved, (double) (zstrings_ref_bytes - zstrings_bytes));
+		info.GetReturnValue().Set(stats);
+	}
+}
@@ -0,0 +1,173 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	static const char *value_type_names[] = {
+		"bool", "byte", "decimal", "int", "list", "schedule",
+		"short", "string", "button", "raw", "bitset", NULL
+	};
+
+	static const char *value_genre_names[] = {
+		"basic", "user", "config", "system", NULL
+	};
+
+	static int nameIndex(const char **names, ::std::string const &name, int def)
+	{
+		for (int i = 0; names[i]; i++) {
+			if (name == names[i]) {
+				return i;
+			}
+		}
+		return def;
+	}
+
+	static Local<Value> getProp(Local<Object> o, const char *name)
+	{
+		return Nan::Get(o, Nan::New<String>(name).ToLocalChecked()).ToLocalChecked();
+	}
+
+	static double getNumberProp(Local<Object> o, const char *name, double def)
+	{
+		Local<Value> v = getProp(o, name);
+		return v->IsUndefined() ? def : Nan::To<double>(v).FromMaybe(def);
+	}
+
+	static ::std::string getStringProp(Local<Object> o, const char *name, const char *def)
+	{
+		Local<Value> v = getProp(o, name);
+		return v->IsUndefined() ? ::std::string(def) : ::std::string(*Nan::Utf8String(v));
+	}
+
+	// what captureValue() would have read from OpenZWave
+	static void fakeCaptureValue(OpenZWave::ValueID const &value, Local<Value> v, uint8 precision, CachedValue &cache)
+	{
+		cache.valid = !v->IsUndefined();
+		if (!cache.valid) {
+			return;
+		}
+		switch (value.GetType()) {
+		case OpenZWave::ValueID::ValueType_Bool:
+			cache.num.b = Nan::To<bool>(v).FromJust();
+			break;
+		case OpenZWave::ValueID::ValueType_Byte:
+			cache.num.byte = Nan::To<uint32_t>(v).FromJust();
+			break;
+		case OpenZWave::ValueID::ValueType_Decimal: {
+			char buffer[64];
+			cache.num.f = Nan::To<double>(v).FromJust();
+			cache.precision = precision;
+			snprintf(buffer, sizeof(buffer), "%.*f", precision, cache.num.f);
+			cache.str = buffer;
+			break;
+		}
+		case OpenZWave::ValueID::ValueType_Int:
+#if OPENZWAVE_16
+		case OpenZWave::ValueID::ValueType_BitSet:
+#endif
+			cache.num.i = Nan::To<int32_t>(v).FromJust();
+			break;
+		case OpenZWave::ValueID::ValueType_Short:
+			cache.num.s = Nan::To<int32_t>(v).FromJust();
+			break;
+		case OpenZWave::ValueID::ValueType_List:
+		case OpenZWave::ValueID::ValueType_String:
+			cache.str = *Nan::Utf8String(v);
+			break;
+		case OpenZWave::ValueID::ValueType_Raw:
+			if (Buffer::HasInstance(v)) {
+				cache.str.assign(Buffer::Data(v), Buffer::Length(v));
+			}
+			break;
+		default:
+			cache.valid = false;
+			break;
+		}
+	}
+
+	/*
+	* Feed a synthetic notification through the notification handler, as if
+	* it came from OpenZWave. Only meant for the tests, which run without a
+	* controller (and without starting OpenZWave at all), so that they can
+	* drive the native state. For the value notifications 'opts' describes
+	* the value and, on ValueAdded, its metadata:
+	*   { class_id, instance, index, type, genre, value, precision,
+	*     label, units, help, min, max, read_only, write_only, polled }
+	* The polling ones only the value. The others take { event, notification, help }. 'ts' is when it was
+	* sent (msec since the epoch), now by default.
+	*/
+	// ===================================================================
+	NAN_METHOD(OZW::InjectNotification)
+	// ===================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(2, "type, nodeid");
+		Local<Object> opts = Nan::New<Object>();
+		if ((info.Length() > 2) && info[2]->IsObject()) {
+			opts = Nan::To<Object>(info[2]).ToLocalChecked();
+		}
+
+		NotifInfo *notif = new NotifInfo();
+		notif->type   = Nan::To<uint32_t>(info[0]).FromJust();
+		notif->homeid = homeid;
+		notif->nodeid = Nan::To<uint32_t>(info[1]).FromJust();
+		notif->ts = ((info.Length() > 3) && info[3]->IsNumber()) ?
+			Nan::To<double>(info[3]).FromJust() : nowMsec();
+		notif->value.valid = false;
+		notif->meta.valid = false;
+		notif->event        = getNumberProp(opts, "event", 0);
+		notif->notification = getNumberProp(opts, "notification", 0);
+		notif->help         = getStringProp(opts, "help", "");
+		if ((notif->type <= OpenZWave::Notification::Type_ValueRefreshed)
+				|| (notif->type == OpenZWave::Notification::Type_PollingEnabled)
+				|| (notif->type == OpenZWave::Notification::Type_PollingDisabled)) {
+			OpenZWave::ValueID value(homeid, notif->nodeid,
+				(OpenZWave::ValueID::ValueGenre) nameIndex(value_genre_names, getStringProp(opts, "genre", "user"), 1),
+				getNumberProp(opts, "class_id", 0),
+				getNumberProp(opts, "instance", 1),
+				getNumberProp(opts, "index", 0),
+				(OpenZWave::ValueID::ValueType) nameIndex(value_type_names, getStringProp(opts, "type", "byte"), 1));
+			notif->values.push_front(value);
+			if ((notif->type != OpenZWave::Notification::Type_ValueRemoved)
+					&& (notif->type <= OpenZWave::Notification::Type_ValueRefreshed)) {
+				fakeCaptureValue(value, getProp(opts, "value"), getNumberProp(opts, "precision", 0), notif->value);
+			}
+			if (notif->type == OpenZWave::Notification::Type_ValueAdded) {
+				notif->meta.label      = getStringProp(opts, "label", "");
+				notif->meta.units      = getStringProp(opts, "units", "");
+				notif->meta.help       = notif->help;
+				notif->meta.read_only  = getNumberProp(opts, "read_only", 0) != 0;
+				notif->meta.write_only = getNumberProp(opts, "write_only", 0) != 0;
+				notif->meta.min        = getNumberProp(opts, "min", 0);
+				notif->meta.max        = getNumberProp(opts, "max", 0);
+				notif->meta.polled     = getNumberProp(opts, "polled", 0) != 0;
+				notif->meta.valid = true;
+			}
+		}
+		memory_count_notif(notif, true);
+		{
+			mutex::scoped_lock sl(zqueue_mutex);
+			zqueue.push(notif);
+		}
+		// handled right away, the events are emitted before this returns
+		async_cb_handler(&async);
+	}
+}
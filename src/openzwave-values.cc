@@ -21,6 +21,96 @@ using namespace v8;
 using namespace node;
 
 namespace OZW {
+	/*
+	* Set a value from the JS argument at position validx, according to
+	* the ValueID's type.
+	*/
+	static void setValueFromArg(OpenZWave::ValueID &vid, const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 validx)
+	{
+		switch (vid.GetType()) {
+			case OpenZWave::ValueID::ValueType_Bool: {
+				bool val = Nan::To<Boolean>(info[validx]).ToLocalChecked()->Value();
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Byte: {
+				uint8 val = Nan::To<Integer>(info[validx]).ToLocalChecked()->Value();
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Decimal: {
+				float val = Nan::To<Number>(info[validx]).ToLocalChecked()->Value();
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Int: {
+				int32 val = Nan::To<Integer>(info[validx]).ToLocalChecked()->Value();
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_List: {
+				::std::string val(*Nan::Utf8String( info[validx] ));
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Short: {
+				int16 val = Nan::To<Integer>(info[validx]).ToLocalChecked()->Value();
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_String: {
+				::std::string val(*Nan::Utf8String( info[validx] ));
+				OZWManager( SetValue, vid, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Schedule: {
+				Nan::ThrowTypeError("please use the specialized xxxSwitchPoint commands instead of setValue for setting thermostat schedules");
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Button: {
+				if (checkType(info[validx]->IsBoolean())) {
+					if (Nan::To<Boolean>(info[validx]).ToLocalChecked()->Value()) {
+						OZWManager( PressButton, vid);
+					} else {
+						OZWManager( ReleaseButton, vid);
+					}
+				}
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Raw: {
+				checkType(Buffer::HasInstance(info[validx]));
+				uint8 *val = (uint8*)Buffer::Data(info[validx]);
+				uint8 len  = Buffer::Length(info[validx]);
+				OZWManager( SetValue, vid, val, len);
+				break;
+			}
+#if OPENZWAVE_16
+			case OpenZWave::ValueID::ValueType_BitSet: {
+				uint8 pos = Nan::To<Number>(info[validx]).ToLocalChecked()->Value();
+				bool val = Nan::To<Boolean>(info[validx+1]).ToLocalChecked()->Value();
+				OZWManager( SetValue, vid, pos, val);
+			}
+#endif
+		}
+	}
+
+	/*
+	* Values loaded from the warm start file can be read, but OpenZWave
+	* doesn't know them until their 'value added': throw instead of
+	* passing it an id it would reject (or worse, ignore).
+	*/
+	static bool checkNotStale(ValueInfo *vinfo)
+	{
+		if (vinfo->stale) {
+			::std::string errmsg(
+				::std::string("OpenZWave valueId not added yet (only known from the warm start file): ") +
+				getValueIdDescriptor(vinfo->id));
+			Nan::ThrowError(errmsg.c_str());
+			return false;
+		}
+		return true;
+	}
+
 	/*
 	* Generic value set.
 	*/
@@ -30,74 +120,39 @@ namespace OZW {
 	{
 		Nan::HandleScope scope;
 		CheckMinArgs(1, "valueId");
-		OpenZWave::ValueID* vit = populateValueId(info);
-		if (vit) {
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo && checkNotStale(vinfo)) {
 			uint8 validx  =  (info[0]->IsObject()) ? 1 : 4;
-			switch ((*vit).GetType()) {
-				case OpenZWave::ValueID::ValueType_Bool: {
-					bool val = Nan::To<Boolean>(info[validx]).ToLocalChecked()->Value();
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Byte: {
-					uint8 val = Nan::To<Integer>(info[validx]).ToLocalChecked()->Value();
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Decimal: {
-					float val = Nan::To<Number>(info[validx]).ToLocalChecked()->Value();
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Int: {
-					int32 val = Nan::To<Integer>(info[validx]).ToLocalChecked()->Value();
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_List: {
-					::std::string val(*Nan::Utf8String( info[validx] ));
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Short: {
-					int16 val = Nan::To<Integer>(info[validx]).ToLocalChecked()->Value();
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_String: {
-					::std::string val(*Nan::Utf8String( info[validx] ));
-					OZWManager( SetValue, *vit, val);
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Schedule: {
-					Nan::ThrowTypeError("please use the specialized xxxSwitchPoint commands instead of setValue for setting thermostat schedules");
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Button: {
-					if (checkType(info[validx]->IsBoolean())) {
-						if (Nan::To<Boolean>(info[validx]).ToLocalChecked()->Value()) {
-							OZWManager( PressButton, *vit);
-						} else {
-							OZWManager( ReleaseButton, *vit);
-						}
-					}
-					break;
-				}
-				case OpenZWave::ValueID::ValueType_Raw: {
-					checkType(Buffer::HasInstance(info[validx]));
-					uint8 *val = (uint8*)Buffer::Data(info[validx]);
-					uint8 len  = Buffer::Length(info[validx]);
-					OZWManager( SetValue, *vit, val, len);
-					break;
-				}
-#if OPENZWAVE_16
-				case OpenZWave::ValueID::ValueType_BitSet: {
-					uint8 pos = Nan::To<Number>(info[validx]).ToLocalChecked()->Value();
-					bool val = Nan::To<Boolean>(info[validx+1]).ToLocalChecked()->Value();
-					OZWManager( SetValue, *vit, pos, val);
-				}
-#endif
-			}
+			setValueFromArg(vinfo->id, info, validx);
+		}
+	}
+
+	/*
+	* Resolve a ValueID into an opaque integer handle, to be used with the
+	* xxxByHandle calls below. These skip the JS object property lookups
+	* and the search through the node's value list.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::ResolveValue)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "valueId");
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo) {
+			info.GetReturnValue().Set(Nan::New<Uint32>(vinfo->handle));
+		}
+	}
+
+	// =================================================================
+	NAN_METHOD(OZW::SetValueByHandle)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(2, "handle, value");
+		ValueInfo* vinfo = populateValueHandle(info);
+		if (vinfo && checkNotStale(vinfo)) {
+			setValueFromArg(vinfo->id, info, 1);
 		}
 	}
 
@@ -107,12 +162,14 @@ namespace OZW {
 	{
 		Nan::HandleScope scope;
 		CheckMinArgs(2, "valueid, label");
-		OpenZWave::ValueID* vit = populateValueId(info);
+		ValueInfo* vinfo = populateValueInfo(info);
 		uint8 validx  =  (info[0]->IsObject()) ? 1 : 4;
 		::std::string label(*Nan::Utf8String( info[validx] ));
 
-		if (vit) {
-			OZWManager( SetValueLabel, *vit, label);
+		if (vinfo) {
+			OZWManager( SetValueLabel, vinfo->id, label);
+			vinfo->meta_cached = false;
+			vinfo->bits_cached = false;
 		}
 	}
 
@@ -125,14 +182,178 @@ namespace OZW {
 	{
 		Nan::HandleScope scope;
 		CheckMinArgs(1, "valueId");
-		OpenZWave::ValueID* vit = populateValueId(info);
-		if (vit) {
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo && checkNotStale(vinfo)) {
 			bool ok = false;
-			OZWManagerAssign(ok, RefreshValue, *vit);
+			OZWManagerAssign(ok, RefreshValue, vinfo->id);
+			info.GetReturnValue().Set(Nan::New<Boolean>(ok));
+		}
+	}
+
+	// =================================================================
+	NAN_METHOD(OZW::RefreshValueByHandle)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "handle");
+		ValueInfo* vinfo = populateValueHandle(info);
+		if (vinfo && checkNotStale(vinfo)) {
+			bool ok = false;
+			OZWManagerAssign(ok, RefreshValue, vinfo->id);
 			info.GetReturnValue().Set(Nan::New<Boolean>(ok));
 		}
 	}
 
+	/*
+	* Copy the state of all values of a node, to build the value objects
+	* from after releasing znodes_mutex. Caller holds it.
+	*/
+	static void copyNodeValues(::std::vector<ValueState> &states, NodeInfo *node)
+	{
+		::std::list<ValueInfo>::iterator vit;
+		for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+			states.push_back(ValueState(&*vit));
+		}
+	}
+
+	// the value objects, populated according to the ValueFields mask
+	static Local<Array> valueStates2v8Array(::std::vector<ValueState> &states, uint32 fields)
+	{
+		Nan::EscapableHandleScope scope;
+		Local<Array> values = Nan::New<Array>(states.size());
+		for (uint32 idx = 0; idx < states.size(); idx++) {
+			Nan::Set(values, idx, valueState2v8Value(states[idx], fields));
+		}
+		return scope.Escape(values);
+	}
+
+	static uint32 getValueFieldsArg(const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 offset)
+	{
+		if ((info.Length() > offset) && info[offset]->IsNumber()) {
+			return Nan::To<uint32_t>(info[offset]).FromJust();
+		}
+		return ValueField_All;
+	}
+
+	/*
+	* Get all the values of a single node in one call.
+	* Unknown nodes yield an empty array.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetValues)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "nodeid");
+		uint8 nodeid = Nan::To<Number>(info[0]).ToLocalChecked()->Value();
+		uint32 fields = getValueFieldsArg(info, 1);
+
+		::std::vector<ValueState> states;
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			NodeInfo *node = get_node_info(nodeid);
+			if (node) {
+				copyNodeValues(states, node);
+			}
+		}
+		info.GetReturnValue().Set(valueStates2v8Array(states, fields));
+	}
+
+	/*
+	* Get the values of all known nodes in one call.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetAllValues)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		uint32 fields = getValueFieldsArg(info, 0);
+
+		::std::vector<ValueState> states;
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			NodeInfo *node;
+			for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+				if (!(node = get_node_info(nodeid))) {
+					continue;
+				}
+				copyNodeValues(states, node);
+			}
+		}
+		info.GetReturnValue().Set(valueStates2v8Array(states, fields));
+	}
+
+	/*
+	* Get the last known value, as kept from the notifications. This never
+	* calls into OpenZWave, undefined if the value hasn't been reported yet.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetValue)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "valueId");
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo) {
+			info.GetReturnValue().Set(cachedValue2v8Value(vinfo->id, vinfo->cache.get()));
+		}
+	}
+
+	// =================================================================
+	NAN_METHOD(OZW::GetValueByHandle)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "handle");
+		ValueInfo* vinfo = populateValueHandle(info);
+		if (vinfo) {
+			info.GetReturnValue().Set(cachedValue2v8Value(vinfo->id, vinfo->cache.get()));
+		}
+	}
+
+	/*
+	* Get the value as a string, ie. a Decimal in its string form
+	* when the DecimalAsNumber option is set.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetValueAsString)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "valueId");
+		OpenZWave::ValueID* vit = populateValueId(info);
+		if (vit) {
+			::std::string val;
+			OZWManager(GetValueAsString, *vit, &val);
+			info.GetReturnValue().Set(Nan::New<String>(val).ToLocalChecked());
+		}
+	}
+
+	/*
+	* Get the items of a List value. These are cached natively, and
+	* only sent along with 'value added' otherwise.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::GetValueListItems)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		CheckMinArgs(1, "valueId");
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo) {
+			if (vinfo->id.GetType() != OpenZWave::ValueID::ValueType_List ) {
+				Nan::ThrowTypeError("OpenZWave valueId is not a ValueType_List");
+				return;
+			}
+			const ::std::vector< ::std::string > &items = get_value_list_items(vinfo);
+			Local<Array> values = Nan::New<Array>(items.size());
+			for (unsigned int i = 0; i < items.size(); i++) {
+				Nan::Set(values, i, Nan::New<String>(items[i]).ToLocalChecked());
+			}
+			info.GetReturnValue().Set(values);
+		}
+	}
+
 	/*
 	* Ask OZW to verify the value change before notifying the application
 	*/
@@ -306,9 +527,9 @@ namespace OZW {
 	// =================================================================
 	{
 		CheckMinArgs(2, "valueid, mask");
-		OpenZWave::ValueID* vit = populateValueId(info);
-		if (vit) {
-			if ((*vit).GetType() != OpenZWave::ValueID::ValueType_BitSet ) {
+		ValueInfo* vinfo = populateValueInfo(info);
+		if (vinfo) {
+			if (vinfo->id.GetType() != OpenZWave::ValueID::ValueType_BitSet ) {
 				Nan::ThrowTypeError("OpenZWave valueId is not a ValueType_BitSet");
 			}
 			uint8 idxpos  =  (info[0]->IsObject()) ? 1 : 4;
@@ -316,7 +537,8 @@ namespace OZW {
 				Nan::ThrowTypeError("must supply an integer for _mask after the valueId");
 			} else {
 				uint32 _mask = Nan::To<Number>(info[idxpos]).ToLocalChecked()->Value();
-				OZWManager(SetBitMask, *vit, _mask);
+				OZWManager(SetBitMask, vinfo->id, _mask);
+				vinfo->bits_cached = false;
 			}
 		}
 	}
@@ -0,0 +1,214 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <limits>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+namespace OZW {
+
+	/*
+	* Network-wide table of all numeric values, shared with JS land as
+	* typed arrays: slot i holds the current value of handles[i] (0 marks
+	* an empty slot) and generations[i] is bumped on every update of it.
+	* The memory belongs to the typed arrays (freed when they get garbage
+	* collected), we only keep them alive for as long as the table is enabled.
+	* Only ever touched from the v8 thread.
+	*/
+	static double  *vt_values      = NULL;
+	static uint32  *vt_handles     = NULL;
+	static uint32  *vt_generations = NULL;
+	static uint32   vt_capacity    = 0;
+	static ::std::vector<uint32> vt_free_slots;
+	static Nan::Persistent<Object> vt_obj;
+
+	// there can't be more numeric values than value handles
+	#define VALUE_TABLE_MAX_CAPACITY HANDLE_SLOT_MASK
+
+	static bool isNumericValue(OpenZWave::ValueID const &value)
+	{
+		switch (value.GetType()) {
+			case OpenZWave::ValueID::ValueType_Bool:
+			case OpenZWave::ValueID::ValueType_Byte:
+			case OpenZWave::ValueID::ValueType_Decimal:
+			case OpenZWave::ValueID::ValueType_Int:
+			case OpenZWave::ValueID::ValueType_Short:
+#if OPENZWAVE_16
+			case OpenZWave::ValueID::ValueType_BitSet:
+#endif
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	/*
+	* Give a newly added numeric value a slot in the table, if there's
+	* one left. Caller holds znodes_mutex.
+	*/
+	void value_table_add(ValueInfo *vinfo)
+	{
+		if (!vt_values || vt_free_slots.empty() || !isNumericValue(vinfo->id)) {
+			return;
+		}
+		vinfo->table_slot = vt_free_slots.back();
+		vt_free_slots.pop_back();
+		vt_handles[vinfo->table_slot] = vinfo->handle;
+		value_table_update(vinfo);
+	}
+
+	void value_table_update(ValueInfo *vinfo)
+	{
+		if (!vt_values || !vinfo || (vinfo->table_slot < 0)) {
+			return;
+		}
+		// straight from the notification's copy: no Manager calls under the lock
+		double val;
+		if (cachedValueAsDouble(vinfo->id, vinfo->cache.get(), &val)) {
+			vt_values[vinfo->table_slot] = val;
+			vt_generations[vinfo->table_slot]++;
+		}
+	}
+
+	// free up the slot of a removed value. Caller holds znodes_mutex.
+	void value_table_remove(ValueInfo *vinfo)
+	{
+		if (!vt_values || (vinfo->table_slot < 0)) {
+			return;
+		}
+		vt_handles[vinfo->table_slot] = 0;
+		vt_values[vinfo->table_slot] = ::std::numeric_limits<double>::quiet_NaN();
+		vt_generations[vinfo->table_slot]++;
+		vt_free_slots.push_back(vinfo->table_slot);
+		vinfo->table_slot = -1;
+	}
+
+	// number of slots, 0 if the table is disabled
+	uint32 value_table_capacity()
+	{
+		return vt_capacity;
+	}
+
+	static void releaseValueTable()
+	{
+		mutex::scoped_lock sl(znodes_mutex);
+		NodeInfo *node;
+		::std::list<ValueInfo>::iterator vit;
+		for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+			if (!(node = get_node_info(nodeid))) {
+				continue;
+			}
+			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+				vit->table_slot = -1;
+			}
+		}
+		vt_values = NULL;
+		vt_handles = NULL;
+		vt_generations = NULL;
+		vt_capacity = 0;
+		vt_free_slots.clear();
+		vt_obj.Reset();
+	}
+
+	/*
+	* Enable the value table with room for 'capacity' numeric values
+	* (default 1024, at most one per value handle). Values beyond that are
+	* simply left out.
+	* Returns { values: Float64Array, handles: Uint32Array, generations: Uint32Array }
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::EnableValueTable)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		uint32 capacity = 1024;
+		if ((info.Length() > 0) && info[0]->IsNumber()) {
+			capacity = Nan::To<uint32_t>(info[0]).FromJust();
+		}
+		if ((capacity == 0) || (capacity > VALUE_TABLE_MAX_CAPACITY)) {
+			Nan::ThrowRangeError("value table capacity must be between 1 and 1048575");
+			return;
+		}
+		releaseValueTable();
+
+		void *values, *handles, *generations;
+		Local<ArrayBuffer> values_ab      = newExternalArrayBuffer(capacity * sizeof(double), &values);
+		if (!values) {
+			return;
+		}
+		Local<ArrayBuffer> handles_ab     = newExternalArrayBuffer(capacity * sizeof(uint32), &handles);
+		if (!handles) {
+			return;
+		}
+		Local<ArrayBuffer> generations_ab = newExternalArrayBuffer(capacity * sizeof(uint32), &generations);
+		if (!generations) {
+			return;
+		}
+		try {
+			vt_free_slots.reserve(capacity);
+		} catch (::std::bad_alloc const &) {
+			Nan::ThrowError("out of memory allocating the value table");
+			return;
+		}
+
+		Local<Object> table = Nan::New<Object>();
+		Nan::Set(table, Nan::New<String>("values").ToLocalChecked(),
+			Float64Array::New(values_ab, 0, capacity));
+		Nan::Set(table, Nan::New<String>("handles").ToLocalChecked(),
+			Uint32Array::New(handles_ab, 0, capacity));
+		Nan::Set(table, Nan::New<String>("generations").ToLocalChecked(),
+			Uint32Array::New(generations_ab, 0, capacity));
+		vt_obj.Reset(table);
+
+		vt_values      = (double *) values;
+		vt_handles     = (uint32 *) handles;
+		vt_generations = (uint32 *) generations;
+		vt_capacity    = capacity;
+		for (uint32 slot = capacity; slot > 0; slot--) {
+			vt_values[slot - 1] = ::std::numeric_limits<double>::quiet_NaN();
+			vt_free_slots.push_back(slot - 1);
+		}
+
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			NodeInfo *node;
+			::std::list<ValueInfo>::iterator vit;
+			for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++) {
+				if (!(node = get_node_info(nodeid))) {
+					continue;
+				}
+				for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+					value_table_add(&*vit);
+				}
+			}
+		}
+		info.GetReturnValue().Set(table);
+	}
+
+	/*
+	* Stop updating the value table. JS land may still hold the arrays,
+	* which then simply keep their last contents.
+	*/
+	// =================================================================
+	NAN_METHOD(OZW::DisableValueTable)
+	// =================================================================
+	{
+		Nan::HandleScope scope;
+		releaseValueTable();
+	}
+}
@@ -0,0 +1,565 @@
+/*
+* Copyright (c) 2015-2017 Elias Karakoulakis <elias.karakoulakis@gmail.com>
+*
+* Permission to use, copy, modify, and distribute this software for any
+* purpose with or without fee is hereby granted, provided that the above
+* copyright notice and this permission notice appear in all copies.
+*
+* THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+* WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+* MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+* ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+* WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+* ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+* OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include "openzwave.hpp"
+
+using namespace v8;
+using namespace node;
+
+#define WARMSTART_FILE    "ozw_warmstart.bin"
+#define WARMSTART_VERSION 1
+
+/*
+* The warm start file: a header, then fixed size node and value records
+* (the values ordered by node), then a pool of the strings they refer to,
+* each a 32-bit length followed by its bytes, padded to 4 bytes. It's
+* read in one go, and the records copied out of the buffer one by one.
+* Written in the host's byte order: not to be moved between machines.
+*/
+namespace OZW {
+
+	typedef struct {
+		char   magic[4];      // "OZWS"
+		uint32 version;
+		double saved_at;      // msec since the epoch
+		uint32 node_count;
+		uint32 value_count;
+		uint32 strings_size;
+		uint32 reserved;
+	} WarmStartHeader;
+
+	enum WarmStartNodeFlags {
+		WarmStartNode_Listening         = 0x01,
+		WarmStartNode_FrequentListening = 0x02,
+		WarmStartNode_Beaming           = 0x04,
+		WarmStartNode_Routing           = 0x08,
+		WarmStartNode_SecurityDevice    = 0x10,
+		WarmStartNode_NamesValid        = 0x20,
+		WarmStartNode_ProtocolValid     = 0x40
+	};
+
+	typedef struct {
+		uint32 homeid;
+		uint8  nodeid;
+		uint8  flags;
+		uint8  version;
+		uint8  security;
+		uint8  basic;
+		uint8  generic;
+		uint8  specific;
+		uint8  reserved;
+		uint32 max_baud_rate;
+		// manufacturer, manufacturerid, product, producttype, productid, type, name, loc
+		uint32 names[8];
+	} WarmStartNode;
+
+	enum WarmStartValueFlags {
+		WarmStartValue_Valid     = 0x01,
+		WarmStartValue_ReadOnly  = 0x02,
+		WarmStartValue_WriteOnly = 0x04
+	};
+
+	typedef struct {
+		uint64 id;
+		uint32 homeid;
+		uint8  flags;
+		uint8  precision;
+		uint16 reserved;
+		int32  min;
+		int32  max;
+		uint8  num[4];        // CachedValue::num
+		uint32 str;
+		uint32 label;
+		uint32 units;
+		uint32 help;
+		uint32 reserved2;
+	} WarmStartValue;
+
+	// save period in seconds, 0 to disable (see the WarmStartInterval option)
+	uint32 warmstart_interval = 0;
+
+	static ::std::string zwarmstart_path;
+	static uv_timer_t *zwarmstart_timer = NULL;
+	// the loaded state, until emitted as a 'cached snapshot' on the next loop iteration
+	static Nan::Persistent<Object> zcached_snapshot;
+	static double zcached_saved_at = 0;
+
+	/*
+	* Find the stale value loaded for a ValueID that's being added.
+	* Caller holds znodes_mutex.
+	*/
+	ValueInfo *find_stale_value(NodeInfo *node, OpenZWave::ValueID const &value)
+	{
+		::std::list<ValueInfo>::iterator vit;
+		for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+			if (vit->stale && (vit->id == value)) {
+				return &*vit;
+			}
+		}
+		return NULL;
+	}
+
+	/*
+	* Drop the loaded nodes and values that OpenZWave hasn't confirmed,
+	* of a single node or (with -1) of all of them.
+	*/
+	void drop_stale(int nodeid)
+	{
+		::std::vector<uint8> stale_nodes;
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			for (uint32 id = 0; id < NODE_SLOTS; id++) {
+				NodeInfo *node = get_node_info(id);
+				if (!node || ((nodeid >= 0) && ((uint32) nodeid != id))) {
+					continue;
+				}
+				if (node->stale) {
+					stale_nodes.push_back(id);
+					continue;
+				}
+				::std::list<ValueInfo>::iterator vit = node->values.begin();
+				while (vit != node->values.end()) {
+					if (vit->stale) {
+						release_value(&*vit);
+						vit = node->values.erase(vit);
+					} else {
+						++vit;
+					}
+				}
+			}
+		}
+		::std::vector<uint8>::iterator it;
+		for (it = stale_nodes.begin(); it != stale_nodes.end(); ++it) {
+			delete_node(*it);
+		}
+	}
+
+	// string pool under construction, each distinct string stored once
+	typedef struct {
+		::std::vector<char> data;
+		::std::map< ::std::string, uint32 > offsets;
+	} StringPool;
+
+	static uint32 poolString(StringPool &pool, ::std::string const &str)
+	{
+		::std::map< ::std::string, uint32 >::iterator it = pool.offsets.find(str);
+		if (it != pool.offsets.end()) {
+			return it->second;
+		}
+		uint32 offset = pool.data.size();
+		uint32 len = str.size();
+		uint32 padded = (len + 3) & ~3;
+		pool.data.resize(offset + sizeof(len) + padded, 0);
+		memcpy(&pool.data[offset], &len, sizeof(len));
+		if (len > 0) {
+			memcpy(&pool.data[offset + sizeof(len)], str.data(), len);
+		}
+		pool.offsets[str] = offset;
+		return offset;
+	}
+
+	static bool readString(::std::vector<char> const &pool, uint32 offset, ::std::string &str)
+	{
+		uint32 len;
+		if (((uint64) offset + sizeof(len)) > pool.size()) {
+			return false;
+		}
+		memcpy(&len, &pool[offset], sizeof(len));
+		if (((uint64) offset + sizeof(len) + len) > pool.size()) {
+			return false;
+		}
+		str.assign(&pool[offset + sizeof(len)], len);
+		return true;
+	}
+
+	// the state to save, written out on the libuv threadpool
+	typedef struct {
+		uv_work_t req;
+		::std::string path;
+		WarmStartHeader header;
+		::std::vector<WarmStartNode> nodes;
+		::std::vector<WarmStartValue> values;
+		StringPool pool;
+	} WarmStartJob;
+
+	// the job being written, and the newer snapshot waiting for it to finish
+	static WarmStartJob *zwarmstart_writing = NULL;
+	static WarmStartJob *zwarmstart_next = NULL;
+
+	/*
+	* Copy the current node and value state. Whatever isn't cached yet is
+	* fetched from OpenZWave first, so that it's all in memory by the time
+	* the copy is made under znodes_mutex. Only the V8 thread ever changes
+	* the node and value lists, so the first pass needs no lock.
+	*/
+	static WarmStartJob *warmstart_snapshot()
+	{
+		for (uint32 id = 0; id < NODE_SLOTS; id++) {
+			NodeInfo *node = get_node_info(id);
+			if (!node) {
+				continue;
+			}
+			get_node_descriptor(id, false);
+			get_node_descriptor(id, true);
+			::std::list<ValueInfo>::iterator vit;
+			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+				if (!vit->stale) {
+					fetch_value_metadata(&*vit);
+				}
+			}
+		}
+
+		WarmStartJob *job = new WarmStartJob();
+		job->path = zwarmstart_path;
+		StringPool &pool = job->pool;
+		{
+			mutex::scoped_lock sl(znodes_mutex);
+			for (uint32 id = 0; id < NODE_SLOTS; id++) {
+				NodeInfo *node = get_node_info(id);
+				if (!node) {
+					continue;
+				}
+				NodeDescriptor &desc = node->desc;
+				WarmStartNode rec;
+				memset(&rec, 0, sizeof(rec));
+				rec.homeid = node->homeid;
+				rec.nodeid = node->nodeid;
+				rec.flags = (desc.listening ? WarmStartNode_Listening : 0)
+					| (desc.frequent_listening ? WarmStartNode_FrequentListening : 0)
+					| (desc.beaming ? WarmStartNode_Beaming : 0)
+					| (desc.routing ? WarmStartNode_Routing : 0)
+					| (desc.security_device ? WarmStartNode_SecurityDevice : 0)
+					| (desc.names_valid ? WarmStartNode_NamesValid : 0)
+					| (desc.protocol_valid ? WarmStartNode_ProtocolValid : 0);
+				rec.version  = desc.version;
+				rec.security = desc.security;
+				rec.basic    = desc.basic;
+				rec.generic  = desc.generic;
+				rec.specific = desc.specific;
+				rec.max_baud_rate = desc.max_baud_rate;
+				rec.names[0] = poolString(pool, desc.manufacturer);
+				rec.names[1] = poolString(pool, desc.manufacturerid);
+				rec.names[2] = poolString(pool, desc.product);
+				rec.names[3] = poolString(pool, desc.producttype);
+				rec.names[4] = poolString(pool, desc.productid);
+				rec.names[5] = poolString(pool, desc.type);
+				rec.names[6] = poolString(pool, desc.name);
+				rec.names[7] = poolString(pool, desc.loc);
+				job->nodes.push_back(rec);
+
+				::std::list<ValueInfo>::iterator vit;
+				for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
+					if (!vit->meta_cached) {
+						// OpenZWave couldn't tell, nothing to warm start it with
+						continue;
+					}
+					WarmStartValue vrec;
+					memset(&vrec, 0, sizeof(vrec));
+					vrec.id = vit->id.GetId();
+					vrec.homeid = vit->id.GetHomeId();
+					vrec.flags = (vit->read_only ? WarmStartValue_ReadOnly : 0)
+						| (vit->write_only ? WarmStartValue_WriteOnly : 0);
+					vrec.min = vit->min;
+					vrec.max = vit->max;
+					CachedValue const *cache = vit->cache.get();
+					if (cache && cache->valid) {
+						vrec.flags |= WarmStartValue_Valid;
+						vrec.precision = cache->precision;
+						memcpy(vrec.num, &cache->num, sizeof(vrec.num));
+						vrec.str = poolString(pool, cache->str);
+					} else {
+						vrec.str = poolString(pool, "");
+					}
+					vrec.label = poolString(pool, vit->label.str());
+					vrec.units = poolString(pool, vit->units.str());
+					vrec.help  = poolString(pool, vit->help.str());
+					job->values.push_back(vrec);
+				}
+			}
+		}
+
+		WarmStartHeader &header = job->header;
+		memcpy(header.magic, "OZWS", 4);
+		header.version      = WARMSTART_VERSION;
+		header.saved_at     = nowMsec();
+		header.node_count   = job->nodes.size();
+		header.value_count  = job->values.size();
+		header.strings_size = pool.data.size();
+		header.reserved     = 0;
+		return job;
+	}
+
+	/*
+	* Write a snapshot to the warm start file, via a temporary file so that
+	* a crash never leaves a truncated one behind. Runs on the threadpool.
+	*/
+	static void warmstart_write(uv_work_t *req)
+	{
+		WarmStartJob *job = (WarmStartJob *) req->data;
+		::std::string tmppath = job->path + ".tmp";
+		FILE *f = fopen(tmppath.c_str(), "wb");
+		if (!f) {
+			return;
+		}
+		::std::vector<WarmStartNode> const &nodes = job->nodes;
+		::std::vector<WarmStartValue> const &values = job->values;
+		::std::vector<char> const &pool = job->pool.data;
+		bool ok = (fwrite(&job->header, sizeof(job->header), 1, f) == 1)
+			&& (nodes.empty() || (fwrite(&nodes[0], sizeof(WarmStartNode), nodes.size(), f) == nodes.size()))
+			&& (values.empty() || (fwrite(&values[0], sizeof(WarmStartValue), values.size(), f) == values.size()))
+			&& (pool.empty() || (fwrite(&pool[0], 1, pool.size(), f) == pool.size()));
+		ok = (fclose(f) == 0) && ok;
+		if (ok) {
+#ifdef _WIN32
+			remove(job->path.c_str());
+#endif
+			ok = (rename(tmppath.c_str(), job->path.c_str()) == 0);
+		}
+		if (!ok) {
+			remove(tmppath.c_str());
+		}
+	}
+
+	static void warmstart_written(uv_work_t *req, int status);
+
+	static void warmstart_queue(WarmStartJob *job)
+	{
+		zwarmstart_writing = job;
+		job->req.data = job;
+		uv_queue_work(uv_default_loop(), &job->req, warmstart_write, warmstart_written);
+	}
+
+	// back on the V8 thread: write the snapshot taken meanwhile, if any
+	static void warmstart_written(uv_work_t *req, int status)
+	{
+		delete (WarmStartJob *) req->data;
+		zwarmstart_writing = NULL;
+		if (zwarmstart_next) {
+			WarmStartJob *next = zwarmstart_next;
+			zwarmstart_next = NULL;
+			warmstart_queue(next);
+		}
+	}
+
+	/*
+	* Save the current node and value state to the warm start file. The
+	* state is copied right away, the file written in the background.
+	*/
+	void warmstart_save()
+	{
+		if (zwarmstart_path.empty()) {
+			return;
+		}
+		WarmStartJob *job = warmstart_snapshot();
+		if (zwarmstart_writing) {
+			// only the latest state matters
+			delete zwarmstart_next;
+			zwarmstart_next = job;
+		} else {
+			warmstart_queue(job);
+		}
+	}
+
+	/*
+	* Load the warm start file into the node table, as stale nodes and
+	* values. Returns when it was saved (msec since the epoch), 0 if there's
+	* no usable file.
+	*/
+	static double warmstart_load()
+	{
+		FILE *f = fopen(zwarmstart_path.c_str(), "rb");
+		if (!f) {
+			return 0;
+		}
+		::std::vector<char> buf;
+		char chunk[4096];
+		size_t n;
+		while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+			buf.insert(buf.end(), chunk, chunk + n);
+		}
+		fclose(f);
+
+		WarmStartHeader header;
+		if (buf.size() < sizeof(header)) {
+			return 0;
+		}
+		memcpy(&header, &buf[0], sizeof(header));
+		uint64 nodes_at  = sizeof(header);
+		uint64 values_at = nodes_at + (uint64) header.node_count * sizeof(WarmStartNode);
+		uint64 pool_at   = values_at + (uint64) header.value_count * sizeof(WarmStartValue);
+		if ((memcmp(header.magic, "OZWS", 4) != 0) || (header.version != WARMSTART_VERSION)
+			|| (pool_at + header.strings_size != buf.size())) {
+			return 0;
+		}
+		::std::vector<char> pool(buf.begin() + pool_at, buf.end());
+
+		uint32 v = 0;
+		for (uint32 i = 0; i < header.node_count; i++) {
+			WarmStartNode rec;
+			memcpy(&rec, &buf[nodes_at + i * sizeof(WarmStartNode)], sizeof(rec));
+			if (get_node_info(rec.nodeid)) {
+				// already known (connecting again?), the live state wins
+				for (; v < header.value_count; v++) {
+					WarmStartValue vrec;
+					memcpy(&vrec, &buf[values_at + v * sizeof(WarmStartValue)], sizeof(vrec));
+					if (OpenZWave::ValueID(vrec.homeid, vrec.id).GetNodeId() != rec.nodeid) {
+						break;
+					}
+				}
+				continue;
+			}
+			NodeInfo *node = new NodeInfo();
+			node->homeid = rec.homeid;
+			node->nodeid = rec.nodeid;
+			node->polled = false;
+			node->stale  = true;
+			node->throttle = NULL;
+			NodeDescriptor &desc = node->desc;
+			desc.names_valid = (rec.flags & WarmStartNode_NamesValid) != 0;
+			::std::string *names[8] = {
+				&desc.manufacturer, &desc.manufacturerid, &desc.product, &desc.producttype,
+				&desc.productid, &desc.type, &desc.name, &desc.loc
+			};
+			for (uint8 s = 0; s < 8; s++) {
+				desc.names_valid = readString(pool, rec.names[s], *names[s]) && desc.names_valid;
+			}
+			desc.protocol_valid     = (rec.flags & WarmStartNode_ProtocolValid) != 0;
+			desc.listening          = (rec.flags & WarmStartNode_Listening) != 0;
+			desc.frequent_listening = (rec.flags & WarmStartNode_FrequentListening) != 0;
+			desc.beaming            = (rec.flags & WarmStartNode_Beaming) != 0;
+			desc.routing            = (rec.flags & WarmStartNode_Routing) != 0;
+			desc.security_device    = (rec.flags & WarmStartNode_SecurityDevice) != 0;
+			desc.max_baud_rate = rec.max_baud_rate;
+			desc.version  = rec.version;
+			desc.security = rec.security;
+			desc.basic    = rec.basic;
+			desc.generic  = rec.generic;
+			desc.specific = rec.specific;
+
+			{
+				mutex::scoped_lock sl(znodes_mutex);
+				for (; v < header.value_count; v++) {
+					WarmStartValue vrec;
+					memcpy(&vrec, &buf[values_at + v * sizeof(WarmStartValue)], sizeof(vrec));
+					OpenZWave::ValueID id(vrec.homeid, vrec.id);
+					if (id.GetNodeId() != rec.nodeid) {
+						break;
+					}
+					::std::string label, units, help;
+					::std::shared_ptr<CachedValue> cache = ::std::make_shared<CachedValue>();
+					cache->valid = (vrec.flags & WarmStartValue_Valid) != 0;
+					cache->precision = vrec.precision;
+					memcpy(&cache->num, vrec.num, sizeof(vrec.num));
+					if (!readString(pool, vrec.str, cache->str) || !readString(pool, vrec.label, label)
+						|| !readString(pool, vrec.units, units) || !readString(pool, vrec.help, help)) {
+						continue;
+					}
+					node->values.push_back(ValueInfo(id));
+					ValueInfo *vinfo = &node->values.back();
+					vinfo->stale = true;
+					vinfo->meta_cached = true;
+					vinfo->label = InternedString(label);
+					vinfo->units = InternedString(units);
+					vinfo->help  = InternedString(help);
+					vinfo->read_only  = (vrec.flags & WarmStartValue_ReadOnly) != 0;
+					vinfo->write_only = (vrec.flags & WarmStartValue_WriteOnly) != 0;
+					vinfo->min = vrec.min;
+					vinfo->max = vrec.max;
+					vinfo->cache = cache;
+					add_value_handle(vinfo);
+					touch_value(vinfo);
+					value_table_add(vinfo);
+				}
+			}
+			publish_node(node);
+		}
+		return header.saved_at;
+	}
+
+	static void warmstart_timer_cb(uv_timer_t *handle)
+	{
+		if (!zcached_snapshot.IsEmpty()) {
+			// the first round, right after connect() returned
+			Nan::HandleScope scope;
+			Local<v8::Value> emitinfo[3];
+			emitinfo[0] = Nan::New<String>("cached snapshot").ToLocalChecked();
+			emitinfo[1] = Nan::New(zcached_snapshot);
+			emitinfo[2] = Nan::New<Number>(zcached_saved_at);
+			zcached_snapshot.Reset();
+			emit_cb->Call(Nan::New(ctx_obj), 3, emitinfo, resource);
+			return;
+		}
+		warmstart_save();
+	}
+
+	static void warmstart_timer_cb(uv_timer_t *handle, int status)
+	{
+		warmstart_timer_cb(handle);
+	}
+
+	static void warmstart_close_cb(uv_handle_t *handle)
+	{
+		delete (uv_timer_t *) handle;
+	}
+
+	/*
+	* On Connect: load the warm start file from the user path, emit its
+	* contents as a 'cached snapshot' once connect() has returned, and
+	* start saving periodically.
+	*/
+	void warmstart_start(::std::string const &userpath)
+	{
+		if (warmstart_interval == 0) {
+			return;
+		}
+		zwarmstart_path = userpath;
+		if (!zwarmstart_path.empty() && (zwarmstart_path[zwarmstart_path.size() - 1] != '/')) {
+			zwarmstart_path += "/";
+		}
+		zwarmstart_path += WARMSTART_FILE;
+
+		double saved_at = warmstart_load();
+		if (saved_at > 0) {
+			// taken now, before any live notification gets handled
+			Nan::HandleScope scope;
+			zcached_snapshot.Reset(Snapshot::Take());
+			zcached_saved_at = saved_at;
+		}
+
+		if (!zwarmstart_timer) {
+			zwarmstart_timer = new uv_timer_t();
+			uv_timer_init(uv_default_loop(), zwarmstart_timer);
+		}
+		uint64 period = (uint64) warmstart_interval * 1000;
+		uv_timer_start(zwarmstart_timer, warmstart_timer_cb,
+			zcached_snapshot.IsEmpty() ? period : 0, period);
+	}
+
+	// On Disconnect: save one last time, and stop saving periodically.
+	void warmstart_stop()
+	{
+		if (!zwarmstart_timer) {
+			return;
+		}
+		uv_timer_stop(zwarmstart_timer);
+		uv_close((uv_handle_t *) zwarmstart_timer, warmstart_close_cb);
+		zwarmstart_timer = NULL;
+		zcached_snapshot.Reset();
+		warmstart_save();
+	}
+}
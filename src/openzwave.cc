@@ -26,6 +26,7 @@ namespace OZW {
 
 	uint32      homeid;
 	CommandMap* ctrlCmdNames;
+	bool        decimal_as_number = false;
 
 	::std::string ozw_userpath;
 	::std::string ozw_config_path  = stringify( OPENZWAVE_ETC );
@@ -56,6 +57,12 @@ namespace OZW {
 		t->InstanceTemplate()->SetInternalFieldCount(1);
 		// only used to emit dummy event to JS land
 		Nan::SetPrototypeMethod(t, "ping", OZW::Ping);
+		// openzwave-testing.cc, only used by the tests
+		Nan::SetPrototypeMethod(t, "_injectNotification", OZW::InjectNotification);
+		// openzwave-snapshot.cc
+		Nan::SetPrototypeMethod(t, "snapshot", OZW::TakeSnapshot);
+		// openzwave-changes.cc
+		Nan::SetPrototypeMethod(t, "changesSince", OZW::ChangesSince);
 		// openzwave-config.cc
 		Nan::SetPrototypeMethod(t, "setConfigParam", OZW::SetConfigParam);
 		Nan::SetPrototypeMethod(t, "requestConfigParam", OZW::RequestConfigParam);
@@ -75,6 +82,25 @@ namespace OZW {
 		Nan::SetPrototypeMethod(t, "connect", OZW::Connect);
 		Nan::SetPrototypeMethod(t, "disconnect", OZW::Disconnect);
 		Nan::SetPrototypeMethod(t, "updateOptions", OZW::UpdateOptions);
+		// openzwave-filters.cc
+		Nan::SetPrototypeMethod(t, "setDeadband", OZW::SetDeadband);
+		Nan::SetPrototypeMethod(t, "getDeadbandStats", OZW::GetDeadbandStats);
+		Nan::SetPrototypeMethod(t, "throttle", OZW::Throttle);
+		// openzwave-history.cc
+		Nan::SetPrototypeMethod(t, "recordHistory", OZW::RecordHistory);
+		Nan::SetPrototypeMethod(t, "queryHistory", OZW::QueryHistory);
+		// openzwave-meters.cc
+		Nan::SetPrototypeMethod(t, "trackMeters", OZW::TrackMeters);
+		Nan::SetPrototypeMethod(t, "getMeterSummary", OZW::GetMeterSummary);
+		// openzwave-strings.cc
+		Nan::SetPrototypeMethod(t, "getStringTableStats", OZW::GetStringTableStats);
+		// openzwave-profile.cc
+		Nan::SetPrototypeMethod(t, "getStartupProfile", OZW::GetStartupProfile);
+		// openzwave-memory.cc
+		Nan::SetPrototypeMethod(t, "getMemoryStats", OZW::GetMemoryStats);
+		// openzwave-liveness.cc
+		Nan::SetPrototypeMethod(t, "getLiveness", OZW::GetLiveness);
+		Nan::SetPrototypeMethod(t, "setSilenceThreshold", OZW::SetSilenceThreshold);
 		// openzwave-groups.cc
 		Nan::SetPrototypeMethod(t, "getNumGroups", OZW::GetNumGroups);
 		Nan::SetPrototypeMethod(t, "getAssociations", OZW::GetAssociations);
@@ -163,6 +189,7 @@ namespace OZW {
 		Nan::SetPrototypeMethod(t, "getNodeManufacturerId", OZW::GetNodeManufacturerId); // ** new
 		Nan::SetPrototypeMethod(t, "getNodeNeighbors", OZW::GetNodeNeighbors);
 		Nan::SetPrototypeMethod(t, "getNodeClassInformation", OZW::GetNodeClassInformation);
+		Nan::SetPrototypeMethod(t, "getNodeCommandClasses", OZW::GetNodeCommandClasses);
 		Nan::SetPrototypeMethod(t, "getNodeProductId", OZW::GetNodeProductId); // ** new
 		Nan::SetPrototypeMethod(t, "getNodeProductType", OZW::GetNodeProductType); // ** new
 		Nan::SetPrototypeMethod(t, "getNodeSecurity", OZW::GetNodeSecurity); // ** new
@@ -173,14 +200,28 @@ namespace OZW {
 		Nan::SetPrototypeMethod(t, "isNodeBeamingDevice", OZW::IsNodeBeamingDevice); // ** new
 		Nan::SetPrototypeMethod(t, "isNodeRoutingDevice", OZW::IsNodeRoutingDevice); // ** new
 		Nan::SetPrototypeMethod(t, "isNodeSecurityDevice", OZW::IsNodeSecurityDevice); // ** new
+		Nan::SetPrototypeMethod(t, "getNodeInfo", OZW::GetNodeInfo);
+		Nan::SetPrototypeMethod(t, "resolveNode", OZW::ResolveNode);
+		Nan::SetPrototypeMethod(t, "getNodeInfoByHandle", OZW::GetNodeInfoByHandle);
+		Nan::SetPrototypeMethod(t, "getNodes", OZW::GetNodes);
 #if OPENZWAVE_16
 		Nan::SetPrototypeMethod(t, "getMetaData", OZW::GetMetaData);
+		Nan::SetPrototypeMethod(t, "getAllMetaData", OZW::GetAllMetaData);
 		Nan::SetPrototypeMethod(t, "getChangeLog", OZW::GetChangeLog);
 #endif
 		// openzwave-values.cc
 		Nan::SetPrototypeMethod(t, "setValue", OZW::SetValue);
 		Nan::SetPrototypeMethod(t, "setValueLabel", OZW::SetValueLabel);
 		Nan::SetPrototypeMethod(t, "refreshValue", OZW::RefreshValue);
+		Nan::SetPrototypeMethod(t, "resolveValue", OZW::ResolveValue);
+		Nan::SetPrototypeMethod(t, "setValueByHandle", OZW::SetValueByHandle);
+		Nan::SetPrototypeMethod(t, "refreshValueByHandle", OZW::RefreshValueByHandle);
+		Nan::SetPrototypeMethod(t, "getValues", OZW::GetValues);
+		Nan::SetPrototypeMethod(t, "getAllValues", OZW::GetAllValues);
+		Nan::SetPrototypeMethod(t, "getValueListItems", OZW::GetValueListItems);
+		Nan::SetPrototypeMethod(t, "getValue", OZW::GetValue);
+		Nan::SetPrototypeMethod(t, "getValueByHandle", OZW::GetValueByHandle);
+		Nan::SetPrototypeMethod(t, "getValueAsString", OZW::GetValueAsString);
 		Nan::SetPrototypeMethod(t, "setChangeVerified", OZW::SetChangeVerified);
 		Nan::SetPrototypeMethod(t, "getNumSwitchPoints", OZW::GetNumSwitchPoints);
 		Nan::SetPrototypeMethod(t, "clearSwitchPoints", OZW::ClearSwitchPoints);
@@ -193,6 +234,9 @@ namespace OZW {
 		Nan::SetPrototypeMethod(t, "getBitMask", OZW::GetBitMask);
 		Nan::SetPrototypeMethod(t, "getBitSetSize", OZW::GetBitSetSize);
 #endif
+		// openzwave-valuetable.cc
+		Nan::SetPrototypeMethod(t, "enableValueTable", OZW::EnableValueTable);
+		Nan::SetPrototypeMethod(t, "disableValueTable", OZW::DisableValueTable);
 		// openzwave-polling.cc
 		Nan::SetPrototypeMethod(t, "enablePoll", OZW::EnablePoll);
 		Nan::SetPrototypeMethod(t, "disablePoll", OZW::DisablePoll);
@@ -217,6 +261,8 @@ namespace OZW {
 			Nan::New<String>("Emitter").ToLocalChecked(),
 			Nan::GetFunction(t).ToLocalChecked()
 		);
+		// snapshot objects are only created natively, see OZW::TakeSnapshot
+		Snapshot::Init();
 		/* for BeginControllerCommand
 	   * http://openzwave.com/dev/classOpenZWave_1_1Manager.html#aa11faf40f19f0cda202d2353a60dbf7b
 	   */
@@ -278,6 +324,10 @@ namespace OZW {
 					ozw_config_path.assign(argvalstr);
 				} else if (keyname == "LogInitialisation") {
 					self->log_initialisation = (Nan::To<bool>(argval) == Nan::Just(true));
+				} else if (keyname == "DecimalAsNumber") {
+					decimal_as_number = (Nan::To<bool>(argval) == Nan::Just(true));
+				} else if (keyname == "WarmStartInterval") {
+					warmstart_interval = Nan::To<uint32>(argval).FromJust();
 				} else {
 					option_overrides += " --" + keyname + " " + argvalstr;
 				}
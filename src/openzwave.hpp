@@ -19,9 +19,11 @@
 #define __NODE_OPENZWAVE_HPP_INCLUDED__
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <list>
+#include <memory>
 #include <queue>
 
 #include <v8.h>
@@ -52,6 +54,12 @@ namespace OZW {
 	struct OZW : public ObjectWrap {
 		static NAN_METHOD(New);
 		static NAN_METHOD(Ping);
+		// openzwave-testing.cc
+		static NAN_METHOD(InjectNotification);
+		// openzwave-snapshot.cc
+		static NAN_METHOD(TakeSnapshot);
+		// openzwave-changes.cc
+		static NAN_METHOD(ChangesSince);
 		// openzwave-config.cc
 		static NAN_METHOD(SetConfigParam);
 		static NAN_METHOD(RequestConfigParam);
@@ -71,6 +79,25 @@ namespace OZW {
 		static NAN_METHOD(Connect);
 		static NAN_METHOD(Disconnect);
 		static NAN_METHOD(UpdateOptions);
+		// openzwave-filters.cc
+		static NAN_METHOD(SetDeadband);
+		static NAN_METHOD(GetDeadbandStats);
+		static NAN_METHOD(Throttle);
+		// openzwave-history.cc
+		static NAN_METHOD(RecordHistory);
+		static NAN_METHOD(QueryHistory);
+		// openzwave-meters.cc
+		static NAN_METHOD(TrackMeters);
+		static NAN_METHOD(GetMeterSummary);
+		// openzwave-strings.cc
+		static NAN_METHOD(GetStringTableStats);
+		// openzwave-profile.cc
+		static NAN_METHOD(GetStartupProfile);
+		// openzwave-memory.cc
+		static NAN_METHOD(GetMemoryStats);
+		// openzwave-liveness.cc
+		static NAN_METHOD(GetLiveness);
+		static NAN_METHOD(SetSilenceThreshold);
 		// openzwave-groups.cc
 		static NAN_METHOD(GetNumGroups);
 		static NAN_METHOD(GetAssociations);
@@ -169,14 +196,29 @@ namespace OZW {
 		static NAN_METHOD(GetNodeProductId);
 		static NAN_METHOD(GetNodeNeighbors);
 		static NAN_METHOD(GetNodeClassInformation);
+		static NAN_METHOD(GetNodeCommandClasses);
+		static NAN_METHOD(GetNodeInfo);
+		static NAN_METHOD(ResolveNode);
+		static NAN_METHOD(GetNodeInfoByHandle);
+		static NAN_METHOD(GetNodes);
 	#if OPENZWAVE_16
 		static NAN_METHOD(GetMetaData);
+		static NAN_METHOD(GetAllMetaData);
 		static NAN_METHOD(GetChangeLog);
 #endif
 		// openzwave-values.cc
 		static NAN_METHOD(SetValue);
 		static NAN_METHOD(SetValueLabel);
 		static NAN_METHOD(RefreshValue);
+		static NAN_METHOD(ResolveValue);
+		static NAN_METHOD(SetValueByHandle);
+		static NAN_METHOD(RefreshValueByHandle);
+		static NAN_METHOD(GetValues);
+		static NAN_METHOD(GetAllValues);
+		static NAN_METHOD(GetValueListItems);
+		static NAN_METHOD(GetValue);
+		static NAN_METHOD(GetValueByHandle);
+		static NAN_METHOD(GetValueAsString);
 		static NAN_METHOD(SetChangeVerified);
 		static NAN_METHOD(GetNumSwitchPoints);
 		static NAN_METHOD(GetSwitchPoint);
@@ -189,6 +231,9 @@ namespace OZW {
 		static NAN_METHOD(GetBitMask);
 		static NAN_METHOD(GetBitSetSize);
 #endif
+		// openzwave-valuetable.cc
+		static NAN_METHOD(EnableValueTable);
+		static NAN_METHOD(DisableValueTable);
 		// openzwave-polling.cc
 		static NAN_METHOD(GetPollInterval);
 		static NAN_METHOD(SetPollInterval);
@@ -216,12 +261,44 @@ namespace OZW {
 		bool log_initialisation;
 	};
 
+	typedef struct {
+		OpenZWave::ValueID id;
+		::std::shared_ptr<const CachedValue> value;
+	} SnapshotValue;
+
+	/*
+	* An immutable point-in-time copy of the node and value state, see
+	* OZW::TakeSnapshot: one entry per value, sharing its cached contents
+	* with the live state.
+	*/
+	struct Snapshot : public ObjectWrap {
+		static void Init();
+		static v8::Local<v8::Object> NewInstance();
+		static v8::Local<v8::Object> Take();
+		static NAN_METHOD(New);
+		static NAN_METHOD(GetNodeIds);
+		static NAN_METHOD(GetValues);
+		static NAN_METHOD(ToJSON);
+		static Nan::Persistent<v8::Function> constructor;
+		static Nan::Persistent<v8::FunctionTemplate> tmpl;
+
+		uint64 seq;
+		::std::vector<uint8> nodeids;
+		::std::vector<SnapshotValue> values; // ordered by node id
+	};
+
 	// our ZWave Home ID
 	extern uint32 homeid;
 
 	// map of controller command names to enum values
 	extern CommandMap* ctrlCmdNames;
 
+	// emit Decimal values as JS numbers instead of strings
+	extern bool decimal_as_number;
+
+	// seconds between saves of the warm start file, 0 if disabled
+	extern uint32 warmstart_interval;
+
 }
 
 // OpenZWave version constituents
@@ -15,6 +15,10 @@
 * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
 #include "openzwave.hpp"
 #include "Notification.h"
 
@@ -35,29 +39,211 @@ bool checkType(bool predicate)
 	return predicate;
 }
 
+// nodes unpublished from their slot, to be freed by reclaim_nodes()
+static ::std::vector<NodeInfo *> zretired;
+// the last generation published in each node slot
+static uint32 znode_generations[NODE_SLOTS];
+
 /*
-	* Return the node for this request.
+	* Return the node for this request. Lock-free: a node taken from its
+	* slot stays valid until the next reclaim_nodes(), even if it gets
+	* removed meanwhile.
 	*/
 NodeInfo *get_node_info(uint8 nodeid)
+{
+	return znodes[nodeid].load(::std::memory_order_acquire);
+}
+
+/*
+	* Make a fully initialized node visible to the readers.
+	*/
+void publish_node(NodeInfo *node)
 {
 	mutex::scoped_lock sl(znodes_mutex);
-	if (znodes.find(nodeid) != znodes.end())
+	uint32 &generation = znode_generations[node->nodeid];
+	// 24 bits of it go into the node handles, and 0 is never used
+	generation = (generation + 1) & 0xFFFFFF;
+	if (generation == 0)
 	{
-		return znodes[nodeid];
-	};
+		generation = 1;
+	}
+	node->generation = generation;
+	znodes[node->nodeid].store(node, ::std::memory_order_release);
+	memory_count_node(true);
+}
+
+/*
+	* An opaque handle to this incarnation of a node: once the node gets
+	* removed (or reset and added again) it no longer resolves.
+	*/
+uint32 get_node_handle(NodeInfo const *node)
+{
+	return (node->generation << 8) | node->nodeid;
+}
+
+NodeInfo *get_node_by_handle(uint32 handle)
+{
+	NodeInfo *node = get_node_info(handle & 0xFF);
+	if (node && (node->generation == (handle >> 8)))
+	{
+		return node;
+	}
 	return NULL;
 }
 
+/*
+	* Drop all nodes (and their liveness) and free them right away, on disconnect.
+	* Not to be called from the notification handler.
+	*/
+void clear_nodes()
+{
+	for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++)
+	{
+		delete_node(nodeid);
+	}
+	reclaim_nodes();
+	liveness_clear();
+}
+
 /*
 	* Delete NodeInfo after a NodeReset or NodeRemoved notification
 	*/
 void delete_node(uint8 nodeid)
 {
 	mutex::scoped_lock sl(znodes_mutex);
-	if (znodes.erase(nodeid))
+	NodeInfo *node = znodes[nodeid].exchange(NULL, ::std::memory_order_acq_rel);
+	if (node)
+	{
+		// invalidate any handles given out for this node's values
+		::std::list<ValueInfo>::iterator vit;
+		for (vit = node->values.begin(); vit != node->values.end(); ++vit)
+		{
+			release_value(&*vit);
+		}
+		release_throttle(node->throttle);
+		node->throttle = NULL;
+		zretired.push_back(node);
+	}
+}
+
+/*
+	* Free the nodes removed so far. All readers run on the V8 thread, so
+	* this is safe to call whenever it's back to the event loop.
+	*/
+void reclaim_nodes()
+{
+	::std::vector<NodeInfo *> retired;
+	{
+		mutex::scoped_lock sl(znodes_mutex);
+		retired.swap(zretired);
+	}
+	::std::vector<NodeInfo *>::iterator it;
+	for (it = retired.begin(); it != retired.end(); ++it)
+	{
+		delete *it;
+		memory_count_node(false);
+	}
+}
+
+/*
+	* Drop everything attached to a value that's about to be removed.
+	* Caller holds znodes_mutex.
+	*/
+void release_value(ValueInfo *vinfo)
+{
+	value_table_remove(vinfo);
+	forget_value(vinfo);
+	release_throttle(vinfo->throttle);
+	vinfo->throttle = NULL;
+	delete vinfo->history;
+	vinfo->history = NULL;
+	delete vinfo->meter;
+	vinfo->meter = NULL;
+	remove_value_handle(vinfo);
+}
+
+// free slots of the value handle table, reused oldest first
+static ::std::deque<uint32> zfree_handles;
+
+/*
+	* Bind a newly added value to a free handle. Caller holds znodes_mutex.
+	*/
+void add_value_handle(ValueInfo *vinfo)
+{
+	uint32 slot;
+	if (!zfree_handles.empty())
+	{
+		slot = zfree_handles.front();
+		zfree_handles.pop_front();
+	}
+	else
+	{
+		ValueHandleSlot hs = { NULL, 0 };
+		zvalues.push_back(hs);
+		slot = zvalues.size() - 1;
+	}
+	zvalues[slot].vinfo = vinfo;
+	vinfo->handle = (zvalues[slot].generation << HANDLE_SLOT_BITS) | (slot + 1);
+}
+
+void remove_value_handle(ValueInfo *vinfo)
+{
+	uint32 slot = (vinfo->handle & HANDLE_SLOT_MASK) - 1;
+	if ((vinfo->handle != 0) && (slot < zvalues.size()) && (zvalues[slot].vinfo == vinfo))
+	{
+		zvalues[slot].vinfo = NULL;
+		// invalidates the handles given out so far
+		zvalues[slot].generation = (zvalues[slot].generation + 1) & (0xFFFFFFFF >> HANDLE_SLOT_BITS);
+		zfree_handles.push_back(slot);
+	}
+	vinfo->handle = 0;
+}
+
+ValueInfo *get_value_by_handle(uint32 handle)
+{
+	uint32 slot = (handle & HANDLE_SLOT_MASK) - 1;
+	mutex::scoped_lock sl(znodes_mutex);
+	if ((handle != 0) && (slot < zvalues.size())
+		&& (zvalues[slot].generation == (handle >> HANDLE_SLOT_BITS)))
 	{
-		// TODO: extra cleanup??
+		return zvalues[slot].vinfo;
 	}
+	return NULL;
+}
+
+/*
+	* Find the native state of a ValueID, NULL if unknown.
+	*/
+ValueInfo *get_value_info(OpenZWave::ValueID const &value)
+{
+	NodeInfo *node = get_node_info(value.GetNodeId());
+	if (node)
+	{
+		mutex::scoped_lock sl(znodes_mutex);
+		::std::list<ValueInfo>::iterator vit;
+		for (vit = node->values.begin(); vit != node->values.end(); ++vit)
+		{
+			if (vit->id == value)
+			{
+				return &*vit;
+			}
+		}
+	}
+	return NULL;
+}
+
+/*
+	* The items of a List value, fetched from OpenZWave only once.
+	*/
+const ::std::vector< ::std::string > &get_value_list_items(ValueInfo *vinfo)
+{
+	if (!vinfo->items_cached)
+	{
+		vinfo->items.clear();
+		OZWManager(GetValueListItems, vinfo->id, &vinfo->items);
+		vinfo->items_cached = true;
+	}
+	return vinfo->items;
 }
 
 SceneInfo *get_scene_info(uint8 sceneid)
@@ -89,9 +275,159 @@ SceneInfo *get_scene_info(uint8 sceneid)
 	return ::std::string(buffer);
 }
 
+#if OPENZWAVE_16
+// read the label and help of every bit in a BitSet value's mask
+static void getBitSetInfo(OpenZWave::ValueID &value, int32 mask, ::std::vector<BitInfo> &bits)
+{
+	uint8 size = 0;
+	OZWManager(GetBitSetSize, value, &size);
+	uint8 nbits = (size > 4) ? 32 : size * 8;
+
+	bits.clear();
+	for (uint8 pos = 0; pos < nbits; pos++)
+	{
+		if ((mask >> pos) & 1)
+		{
+			::std::string label, help;
+			BitInfo bit;
+			bit.pos = pos + 1;
+			OZWManagerAssign(label, GetValueLabel, value, bit.pos);
+			OZWManagerAssign(help, GetValueHelp, value, bit.pos);
+			bit.label = InternedString(label);
+			bit.help = InternedString(help);
+			bits.push_back(bit);
+		}
+	}
+}
+#endif
+
+// finalizer for Raw value buffers, allocated by Manager::GetValueAsRaw
+static void freeRawValue(char *data, void *hint)
+{
+	delete[] (uint8 *)data;
+}
+
+// a Decimal as a double with its own precision, ie. 21.7 instead of
+// the float's 21.700000762939453
+static double roundDecimal(float val, uint8 precision)
+{
+	double scale = pow(10.0, precision);
+	return round(val * scale) / scale;
+}
+
+// the items of a List value (if asked for) and the index of the selected one
+static void setListItems(Local<Object> &valobj, OpenZWave::ValueID &value, uint32 fields, ValueInfo *vinfo, ::std::string const &val)
+{
+	// the item list is static, only send it along when asked to
+	::std::vector<::std::string> tmpitems;
+	const ::std::vector<::std::string> *items = &tmpitems;
+	if (vinfo)
+	{
+		items = &get_value_list_items(vinfo);
+	}
+	else if (fields & ValueField_Items)
+	{
+		OZWManager(GetValueListItems, value, &tmpitems);
+	}
+	if (fields & ValueField_Items)
+	{
+		AddArrayOfStringProp(valobj, values, (*items));
+	}
+	if (vinfo || (fields & ValueField_Items))
+	{
+		::std::vector<::std::string>::const_iterator sel = ::std::find(items->begin(), items->end(), val);
+		int32 selected_index = (sel != items->end()) ? (int32)(sel - items->begin()) : -1;
+		AddIntegerProp(valobj, selected_index, selected_index);
+	}
+}
+
+#if OPENZWAVE_16
+// the mask of a BitSet value, and the labels of its bits if asked for
+static void setBitSetInfo(Local<Object> &valobj, OpenZWave::ValueID &value, uint32 fields, ValueInfo *vinfo)
+{
+	int32 mask = 0;
+	::std::vector<BitInfo> tmpbits;
+	::std::vector<BitInfo> *bits = &tmpbits;
+	if (vinfo && vinfo->bits_cached)
+	{
+		mask = vinfo->bitmask;
+		bits = &vinfo->bits;
+	}
+	else
+	{
+		OZWManager(GetBitMask, value, &mask);
+		if (vinfo)
+		{
+			// the mask and the labels of known values are read only once
+			vinfo->bitmask = mask;
+			bits = &vinfo->bits;
+			getBitSetInfo(value, mask, *bits);
+			vinfo->bits_cached = true;
+		}
+	}
+
+	// the bit labels are static, so only send them when asked to
+	if (fields & ValueField_Items)
+	{
+		if (!vinfo)
+		{
+			getBitSetInfo(value, mask, *bits);
+		}
+
+		v8::Local<v8::Object> bitSetIds = Nan::New<v8::Object>();
+		::std::vector<BitInfo>::iterator bit;
+		for (bit = bits->begin(); bit != bits->end(); ++bit)
+		{
+			v8::Local<v8::Object> bitObj = Nan::New<v8::Object>();
+			Nan::Set(bitObj, Nan::New<v8::String>("help").ToLocalChecked(), bit->help.v8str());
+			Nan::Set(bitObj, Nan::New<v8::String>("label").ToLocalChecked(), bit->label.v8str());
+			Nan::Set(bitSetIds, Nan::New<v8::String>(::std::to_string(bit->pos)).ToLocalChecked(), bitObj);
+		}
+		Nan::Set(valobj, Nan::New<v8::String>("bitSetIds").ToLocalChecked(), bitSetIds);
+	}
+
+	AddIntegerProp(valobj, bitMask, mask);
+}
+#endif
+
 // populate a v8 object with an attribute called 'value' whose value is the
-// ZWave value, as returned from its proper typed call.
-void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value)
+// ZWave value, from the contents last captured from the notifications
+// (see captureValue). Only the List items and the BitSet mask and labels,
+// which aren't part of those, are asked from OpenZWave.
+static void setCachedValObj(Local<Object> &valobj, OpenZWave::ValueID &value, uint32 fields, ValueInfo *vinfo, CachedValue const *cache)
+{
+	Nan::Set(valobj, Nan::New<String>("value").ToLocalChecked(), cachedValue2v8Value(value, cache));
+	switch (value.GetType())
+	{
+	case OpenZWave::ValueID::ValueType_Decimal:
+	{
+		if (decimal_as_number)
+		{
+			AddIntegerProp(valobj, precision, cache->precision);
+		}
+		break;
+	}
+	case OpenZWave::ValueID::ValueType_List:
+	{
+		setListItems(valobj, value, fields, vinfo, cache->str);
+		break;
+	}
+#if OPENZWAVE_16
+	case OpenZWave::ValueID::ValueType_BitSet:
+	{
+		setBitSetInfo(valobj, value, fields, vinfo);
+		break;
+	}
+#endif
+	default:
+		break;
+	}
+}
+
+// populate a v8 object with an attribute called 'value' whose value is the
+// ZWave value, as returned from its proper typed call. For the values whose
+// contents aren't cached, see valueState2v8Value()
+void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value, uint32 fields, ValueInfo *vinfo)
 {
 	/*
 		* The value itself is type-specific.
@@ -114,9 +450,21 @@ void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value)
 	}
 	case OpenZWave::ValueID::ValueType_Decimal:
 	{
-		::std::string val;
-		OZWManager(GetValueAsString, value, &val);
-		AddStringProp(valobj, value, val);
+		if (decimal_as_number)
+		{
+			float val = 0;
+			uint8 precision = 0;
+			OZWManager(GetValueAsFloat, value, &val);
+			OZWManager(GetValueFloatPrecision, value, &precision);
+			AddNumberProp(valobj, value, roundDecimal(val, precision));
+			AddIntegerProp(valobj, precision, precision);
+		}
+		else
+		{
+			::std::string val;
+			OZWManager(GetValueAsString, value, &val);
+			AddStringProp(valobj, value, val);
+		}
 		break;
 	}
 	case OpenZWave::ValueID::ValueType_Int:
@@ -129,13 +477,11 @@ void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value)
 	case OpenZWave::ValueID::ValueType_List:
 	{
 		::std::string val;
-		::std::vector<::std::string> items;
-		// populate array of all available items in the list
-		OZWManager(GetValueListItems, value, &items);
-		AddArrayOfStringProp(valobj, values, items);
 		// populated selected element
 		OZWManager(GetValueListSelection, value, &val);
-		AddStringProp(valobj, value, val.c_str()) break;
+		AddStringProp(valobj, value, val.c_str());
+		setListItems(valobj, value, fields, vinfo, val);
+		break;
 	}
 	case OpenZWave::ValueID::ValueType_Short:
 	{
@@ -151,44 +497,14 @@ void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value)
 		AddStringProp(valobj, value, val.c_str()) break;
 	}
 #if OPENZWAVE_16
-#define SET(val, offset) val |= (1 << offset)
-#define CLEAR(val, offset) val &= ~(1 << offset)
 	// just return the whole bitset, mask your bit in JS land
 	case OpenZWave::ValueID::ValueType_BitSet:
 	{
-		uint8 val = 0;
-		int32 mask = 0;
-
-		OZWManager(GetBitMask, value, &mask);
-
-		bool bit;
-
-		v8::Local<v8::Object> bitSetIds = Nan::New<v8::Object>();
-
-		uint8 pos = 0;
-
-		for (pos = 0; pos < 8; pos++)
-		{
-			OZWManager(GetValueAsBitSet, value, pos, &bit);
-			bit ? SET(val, pos) : CLEAR(val, pos);
-			// check if bit is set in mask
-			if (1 == ((mask >> bit) & 1))
-			{
-				v8::Local<v8::Object> bitObj = Nan::New<v8::Object>();
-				::std::string help, label;
-				int16 bitIndex = pos + 1;
-				OZWManagerAssign(label, GetValueLabel, value, bitIndex);
-				OZWManagerAssign(help, GetValueHelp, value, bitIndex);
-				AddStringProp(bitObj, help, help.c_str());
-				AddStringProp(bitObj, label, label.c_str());
-				Nan::Set(bitSetIds, Nan::New<v8::String>(::std::to_string(bitIndex)).ToLocalChecked(), bitObj);
-			}
-		}
-		
-		Nan::Set(valobj, Nan::New<v8::String>("bitSetIds").ToLocalChecked(), bitSetIds);
-
-		AddIntegerProp(valobj, bitMask, mask);
+		int32 val = 0;
+		OZWManager(GetValueAsInt, value, &val);
+		setBitSetInfo(valobj, value, fields, vinfo);
 		AddIntegerProp(valobj, value, val);
+		break;
 	}
 #endif
 	/*
@@ -204,12 +520,13 @@ void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value)
 	}
 	case OpenZWave::ValueID::ValueType_Raw:
 	{
-		uint8 *val, len;
+		uint8 *val = NULL, len = 0;
 		OZWManager(GetValueAsRaw, value, &val, &len);
+		// hand the buffer allocated by OpenZWave over to JS land, no copy
 		Nan::Set(valobj,
 				 Nan::New<String>("value").ToLocalChecked(),
-				 Nan::CopyBuffer((char *)val, len).ToLocalChecked());
-		delete[] val;
+				 val ? Nan::NewBuffer((char *)val, len, freeRawValue, NULL).ToLocalChecked()
+					 : Nan::NewBuffer(0).ToLocalChecked());
 		break;
 	}
 	default:
@@ -220,6 +537,220 @@ void setValObj(Local<Object> &valobj, OpenZWave::ValueID &value)
 	}
 }
 
+/*
+	* Read the typed contents of a value into a CachedValue.
+	* Called on the OZW thread from the watcher callback: no v8 in here!
+	*/
+void captureValue(OpenZWave::ValueID const &value, CachedValue &cache)
+{
+	OpenZWave::Manager *mgr = OpenZWave::Manager::Get();
+	cache.valid = false;
+#if OPENZWAVE_EXCEPTIONS
+	try
+	{
+#endif
+		switch (value.GetType())
+		{
+		case OpenZWave::ValueID::ValueType_Bool:
+			cache.valid = mgr->GetValueAsBool(value, &cache.num.b);
+			break;
+		case OpenZWave::ValueID::ValueType_Byte:
+			cache.valid = mgr->GetValueAsByte(value, &cache.num.byte);
+			break;
+		case OpenZWave::ValueID::ValueType_Decimal:
+			cache.valid = mgr->GetValueAsFloat(value, &cache.num.f)
+				&& mgr->GetValueAsString(value, &cache.str)
+				&& mgr->GetValueFloatPrecision(value, &cache.precision);
+			break;
+		case OpenZWave::ValueID::ValueType_Int:
+#if OPENZWAVE_16
+		case OpenZWave::ValueID::ValueType_BitSet:
+#endif
+			cache.valid = mgr->GetValueAsInt(value, &cache.num.i);
+			break;
+		case OpenZWave::ValueID::ValueType_List:
+			cache.valid = mgr->GetValueListSelection(value, &cache.str);
+			break;
+		case OpenZWave::ValueID::ValueType_Short:
+			cache.valid = mgr->GetValueAsShort(value, &cache.num.s);
+			break;
+		case OpenZWave::ValueID::ValueType_String:
+			cache.valid = mgr->GetValueAsString(value, &cache.str);
+			break;
+		case OpenZWave::ValueID::ValueType_Raw:
+		{
+			uint8 *val = NULL, len = 0;
+			cache.valid = mgr->GetValueAsRaw(value, &val, &len);
+			if (val)
+			{
+				cache.str.assign((char *)val, len);
+				delete[] val;
+			}
+			break;
+		}
+		default:
+			// Buttons and Schedules
+			break;
+		}
+#if OPENZWAVE_EXCEPTIONS
+	}
+	catch (OpenZWave::OZWException &e)
+	{
+		cache.valid = false;
+	}
+#endif
+}
+
+/*
+	* Read the static metadata of a value being added into a CachedMetadata,
+	* so that it's at hand without asking OpenZWave on the V8 thread.
+	* Called on the OZW thread from the watcher callback: no v8 in here!
+	*/
+void captureMetadata(OpenZWave::ValueID const &value, CachedMetadata &meta)
+{
+	OpenZWave::Manager *mgr = OpenZWave::Manager::Get();
+	meta.valid = false;
+#if OPENZWAVE_EXCEPTIONS
+	try
+	{
+#endif
+		meta.label      = mgr->GetValueLabel(value);
+		meta.units      = mgr->GetValueUnits(value);
+		meta.help       = mgr->GetValueHelp(value);
+		meta.read_only  = mgr->IsValueReadOnly(value);
+		meta.write_only = mgr->IsValueWriteOnly(value);
+		meta.min        = mgr->GetValueMin(value);
+		meta.max        = mgr->GetValueMax(value);
+		meta.polled     = mgr->IsValuePolled(value);
+		meta.valid = true;
+#if OPENZWAVE_EXCEPTIONS
+	}
+	catch (OpenZWave::OZWException &e)
+	{
+		meta.valid = false;
+	}
+#endif
+}
+
+// the JS form of a cached value, same as the 'value' property of value objects
+v8::Local<v8::Value> cachedValue2v8Value(OpenZWave::ValueID const &value, CachedValue const *cache)
+{
+	Nan::EscapableHandleScope handle_scope;
+	v8::Local<v8::Value> val = Nan::Undefined();
+	if (cache && cache->valid)
+	{
+		switch (value.GetType())
+		{
+		case OpenZWave::ValueID::ValueType_Bool:
+			val = Nan::New<Boolean>(cache->num.b);
+			break;
+		case OpenZWave::ValueID::ValueType_Byte:
+			val = Nan::New<Integer>(cache->num.byte);
+			break;
+		case OpenZWave::ValueID::ValueType_Decimal:
+			if (decimal_as_number)
+			{
+				val = Nan::New<Number>(roundDecimal(cache->num.f, cache->precision));
+			}
+			else
+			{
+				val = Nan::New<String>(cache->str).ToLocalChecked();
+			}
+			break;
+		case OpenZWave::ValueID::ValueType_Int:
+#if OPENZWAVE_16
+		case OpenZWave::ValueID::ValueType_BitSet:
+#endif
+			val = Nan::New<Integer>(cache->num.i);
+			break;
+		case OpenZWave::ValueID::ValueType_Short:
+			val = Nan::New<Integer>(cache->num.s);
+			break;
+		case OpenZWave::ValueID::ValueType_List:
+		case OpenZWave::ValueID::ValueType_String:
+			val = Nan::New<String>(cache->str).ToLocalChecked();
+			break;
+		case OpenZWave::ValueID::ValueType_Raw:
+			val = Nan::CopyBuffer(cache->str.data(), cache->str.size()).ToLocalChecked();
+			break;
+		default:
+			break;
+		}
+	}
+	return handle_scope.Escape(val);
+}
+
+// the contents of a cached numeric (incl. boolean) value as a double,
+// Decimals rounded to their precision like the DecimalAsNumber values
+bool cachedValueAsDouble(OpenZWave::ValueID const &value, CachedValue const *cache, double *o_value)
+{
+	if (!cache || !cache->valid)
+	{
+		return false;
+	}
+	switch (value.GetType())
+	{
+	case OpenZWave::ValueID::ValueType_Bool:    *o_value = cache->num.b ? 1 : 0; return true;
+	case OpenZWave::ValueID::ValueType_Byte:    *o_value = cache->num.byte;      return true;
+	case OpenZWave::ValueID::ValueType_Short:   *o_value = cache->num.s;         return true;
+	case OpenZWave::ValueID::ValueType_Int:     *o_value = cache->num.i;         return true;
+	case OpenZWave::ValueID::ValueType_Decimal: *o_value = roundDecimal(cache->num.f, cache->precision); return true;
+#if OPENZWAVE_16
+	case OpenZWave::ValueID::ValueType_BitSet:  *o_value = cache->num.i;         return true;
+#endif
+	default: return false;
+	}
+}
+
+// whether two cached contents of a value are the same
+bool cachedValueEquals(OpenZWave::ValueID const &value, CachedValue const *a, CachedValue const *b)
+{
+	if (!a || !b || !a->valid || !b->valid)
+	{
+		return (a && a->valid) == (b && b->valid);
+	}
+	switch (value.GetType())
+	{
+	case OpenZWave::ValueID::ValueType_Bool:    return a->num.b == b->num.b;
+	case OpenZWave::ValueID::ValueType_Byte:    return a->num.byte == b->num.byte;
+	case OpenZWave::ValueID::ValueType_Short:   return a->num.s == b->num.s;
+	case OpenZWave::ValueID::ValueType_Int:     return a->num.i == b->num.i;
+	case OpenZWave::ValueID::ValueType_Decimal: return (a->num.f == b->num.f) && (a->precision == b->precision);
+#if OPENZWAVE_16
+	case OpenZWave::ValueID::ValueType_BitSet:  return a->num.i == b->num.i;
+#endif
+	default:                                    return a->str == b->str;
+	}
+}
+
+// wall clock time, msec since the epoch
+double nowMsec()
+{
+	return (double) ::std::chrono::duration_cast< ::std::chrono::milliseconds >(
+		::std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void freeExternalArrayBuffer(char *data, void *hint)
+{
+	free(data);
+}
+
+// allocate a zeroed, natively accessible buffer and wrap it in a JS ArrayBuffer,
+// which owns the memory from then on (freed when garbage collected).
+// Throws and sets *data to NULL if out of memory.
+Local<ArrayBuffer> newExternalArrayBuffer(size_t bytes, void **data)
+{
+	Nan::EscapableHandleScope handle_scope;
+	char *mem = (char *)calloc(bytes > 0 ? bytes : 1, 1);
+	*data = mem;
+	if (!mem) {
+		Nan::ThrowError("out of memory allocating a native buffer");
+		return Local<ArrayBuffer>();
+	}
+	Local<Object> buf = Nan::NewBuffer(mem, bytes, freeExternalArrayBuffer, NULL).ToLocalChecked();
+	return handle_scope.Escape(buf.As<Uint8Array>()->Buffer());
+}
+
 #if !(OPENZWAVE_16)
 // populate a v8 object with an attribute called 'value' whose value is the
 // SCENE value (not the current one!) - as returned from its proper typed call
@@ -247,9 +778,21 @@ void setSceneValObj(uint8 sceneid, Local<Object> &valobj, OpenZWave::ValueID &va
 	}
 	case OpenZWave::ValueID::ValueType_Decimal:
 	{
-		::std::string val;
-		OZWManager(SceneGetValueAsString, sceneid, value, &val);
-		AddStringProp(valobj, value, val);
+		if (decimal_as_number)
+		{
+			float val = 0;
+			uint8 precision = 0;
+			OZWManager(SceneGetValueAsFloat, sceneid, value, &val);
+			OZWManager(GetValueFloatPrecision, value, &precision);
+			AddNumberProp(valobj, value, roundDecimal(val, precision));
+			AddIntegerProp(valobj, precision, precision);
+		}
+		else
+		{
+			::std::string val;
+			OZWManager(SceneGetValueAsString, sceneid, value, &val);
+			AddStringProp(valobj, value, val);
+		}
 		break;
 	}
 	case OpenZWave::ValueID::ValueType_List:
@@ -297,23 +840,248 @@ void setSceneValObj(uint8 sceneid, Local<Object> &valobj, OpenZWave::ValueID &va
 }
 #endif
 
+// (re)read the naming strings of a node, on NodeNaming
+void refresh_node_names(NodeDescriptor &desc, uint32 homeid, uint8 nodeid)
+{
+	OZWManagerAssign(desc.manufacturer,   GetNodeManufacturerName, homeid, nodeid);
+	OZWManagerAssign(desc.manufacturerid, GetNodeManufacturerId, homeid, nodeid);
+	OZWManagerAssign(desc.product,        GetNodeProductName, homeid, nodeid);
+	OZWManagerAssign(desc.producttype,    GetNodeProductType, homeid, nodeid);
+	OZWManagerAssign(desc.productid,      GetNodeProductId, homeid, nodeid);
+	OZWManagerAssign(desc.type,           GetNodeType, homeid, nodeid);
+	OZWManagerAssign(desc.name,           GetNodeName, homeid, nodeid);
+	OZWManagerAssign(desc.loc,            GetNodeLocation, homeid, nodeid);
+	desc.names_valid = true;
+}
+
+// (re)read the protocol information of a node, on NodeProtocolInfo
+void refresh_node_protocol(NodeDescriptor &desc, uint32 homeid, uint8 nodeid)
+{
+	OZWManagerAssign(desc.listening,          IsNodeListeningDevice, homeid, nodeid);
+	OZWManagerAssign(desc.frequent_listening, IsNodeFrequentListeningDevice, homeid, nodeid);
+	OZWManagerAssign(desc.beaming,            IsNodeBeamingDevice, homeid, nodeid);
+	OZWManagerAssign(desc.routing,            IsNodeRoutingDevice, homeid, nodeid);
+	OZWManagerAssign(desc.security_device,    IsNodeSecurityDevice, homeid, nodeid);
+	OZWManagerAssign(desc.max_baud_rate,      GetNodeMaxBaudRate, homeid, nodeid);
+	OZWManagerAssign(desc.version,            GetNodeVersion, homeid, nodeid);
+	OZWManagerAssign(desc.security,           GetNodeSecurity, homeid, nodeid);
+	OZWManagerAssign(desc.basic,              GetNodeBasic, homeid, nodeid);
+	OZWManagerAssign(desc.generic,            GetNodeGeneric, homeid, nodeid);
+	OZWManagerAssign(desc.specific,           GetNodeSpecific, homeid, nodeid);
+	desc.protocol_valid = true;
+}
+
+// command class names, the same for all nodes
+static ::std::string zclass_names[256];
+
+/*
+	* Read the command classes of a node from OpenZWave. They're only cached
+	* (classes_valid) once 'complete', i.e. the node's queries are done:
+	* before that the list may still grow.
+	*/
+void refresh_node_classes(NodeDescriptor &desc, uint32 homeid, uint8 nodeid, bool complete)
+{
+	OpenZWave::Manager *mgr = OpenZWave::Manager::Get();
+	memset(desc.class_bits, 0, sizeof(desc.class_bits));
+	memset(desc.class_versions, 0, sizeof(desc.class_versions));
+	for (uint32 cc = 0; cc < 256; cc++)
+	{
+		::std::string name;
+		uint8 version = 0;
+		if (mgr->GetNodeClassInformation(homeid, nodeid, cc, &name, &version))
+		{
+			desc.class_bits[cc >> 5] |= (1u << (cc & 31));
+			desc.class_versions[cc] = version;
+			if (zclass_names[cc].empty())
+			{
+				zclass_names[cc] = name;
+			}
+		}
+	}
+	desc.classes_valid = complete;
+}
+
+::std::string const &get_class_name(uint8 cc)
+{
+	return zclass_names[cc];
+}
+
+/*
+	* The cached descriptor of a node, with its command classes filled in
+	* (read afresh until the node's queries are complete).
+	* NULL for unknown (or stale) nodes.
+	*/
+NodeDescriptor *get_node_classes(uint8 nodeid)
+{
+	NodeInfo *node = get_node_info(nodeid);
+	if (!node || node->stale)
+	{
+		return NULL;
+	}
+	if (!node->desc.classes_valid)
+	{
+#if OPENZWAVE_EXCEPTIONS
+		try
+		{
+#endif
+			refresh_node_classes(node->desc, node->homeid, nodeid, false);
+#if OPENZWAVE_EXCEPTIONS
+		}
+		catch (OpenZWave::OZWException &e)
+		{
+			return NULL;
+		}
+#endif
+	}
+	return &node->desc;
+}
+
+#if OPENZWAVE_16
+// whether the device database is loaded, so there's metadata to cache
+static bool zmetadata_ready = false;
+
+// read the metadata of a node, unless there's none to be had yet
+void refresh_node_metadata(NodeDescriptor &desc, uint32 homeid, uint8 nodeid)
+{
+	if (!zmetadata_ready)
+	{
+		desc.metadata_valid = false;
+		return;
+	}
+	OpenZWave::Manager *mgr = OpenZWave::Manager::Get();
+	for (uint32 field = 0; field < NODE_METADATA_FIELDS; field++)
+	{
+		desc.metadata[field] = mgr->GetMetaData(homeid, nodeid,
+			static_cast<OpenZWave::Node::MetaDataFields>(field));
+	}
+	desc.metadata_valid = true;
+}
+
+/*
+	* The device database got loaded (or, with false, unloaded on connect):
+	* refresh the metadata of all nodes known so far.
+	*/
+void set_metadata_ready(bool ready)
+{
+	zmetadata_ready = ready;
+	for (uint32 nodeid = 0; nodeid < NODE_SLOTS; nodeid++)
+	{
+		NodeInfo *node = get_node_info(nodeid);
+		if (node && !node->stale)
+		{
+			node->desc.metadata_valid = false;
+			if (ready)
+			{
+				get_node_metadata(nodeid);
+			}
+		}
+	}
+}
+
+/*
+	* The cached descriptor of a node, with its metadata filled in.
+	* NULL for unknown (or stale) nodes, and until the database is ready.
+	*/
+NodeDescriptor *get_node_metadata(uint8 nodeid)
+{
+	NodeInfo *node = get_node_info(nodeid);
+	if (!node || node->stale || !zmetadata_ready)
+	{
+		return NULL;
+	}
+	if (!node->desc.metadata_valid)
+	{
+#if OPENZWAVE_EXCEPTIONS
+		try
+		{
+#endif
+			refresh_node_metadata(node->desc, node->homeid, nodeid);
+#if OPENZWAVE_EXCEPTIONS
+		}
+		catch (OpenZWave::OZWException &e)
+		{
+			return NULL;
+		}
+#endif
+	}
+	return &node->desc;
+}
+#endif
+
+/*
+	* The cached descriptor of a node, with the naming strings (or the
+	* protocol information) filled in. NULL for unknown nodes.
+	*/
+NodeDescriptor *get_node_descriptor(uint8 nodeid, bool protocol)
+{
+	NodeInfo *node = get_node_info(nodeid);
+	if (!node)
+	{
+		return NULL;
+	}
+	// stale nodes are unknown to OpenZWave, serve whatever was loaded
+	if (!node->stale && (protocol ? !node->desc.protocol_valid : !node->desc.names_valid))
+	{
+#if OPENZWAVE_EXCEPTIONS
+		try
+		{
+#endif
+			if (protocol)
+			{
+				refresh_node_protocol(node->desc, node->homeid, nodeid);
+			}
+			else
+			{
+				refresh_node_names(node->desc, node->homeid, nodeid);
+			}
+#if OPENZWAVE_EXCEPTIONS
+		}
+		catch (OpenZWave::OZWException &e)
+		{
+			// let the caller ask OpenZWave itself, and get the error
+			return NULL;
+		}
+#endif
+	}
+	return &node->desc;
+}
+
 // populate a v8 Object with useful information about a ZWave node
 void populateNode(
 	v8::Local<v8::Object> &nodeobj,
 	uint32 homeid, uint8 nodeid)
 {
-	OpenZWave::Manager *mgr = OpenZWave::Manager::Get();
-	AddStringProp(nodeobj, manufacturer, mgr->GetNodeManufacturerName(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, manufacturerid, mgr->GetNodeManufacturerId(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, product, mgr->GetNodeProductName(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, producttype, mgr->GetNodeProductType(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, productid, mgr->GetNodeProductId(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, type, mgr->GetNodeType(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, name, mgr->GetNodeName(homeid, nodeid).c_str());
-	AddStringProp(nodeobj, loc, mgr->GetNodeLocation(homeid, nodeid).c_str());
+	NodeDescriptor *desc = get_node_descriptor(nodeid, false);
+	NodeDescriptor tmpdesc;
+	if (!desc)
+	{
+		desc = &tmpdesc;
+		refresh_node_names(tmpdesc, homeid, nodeid);
+	}
+	AddStringProp(nodeobj, manufacturer, desc->manufacturer.c_str());
+	AddStringProp(nodeobj, manufacturerid, desc->manufacturerid.c_str());
+	AddStringProp(nodeobj, product, desc->product.c_str());
+	AddStringProp(nodeobj, producttype, desc->producttype.c_str());
+	AddStringProp(nodeobj, productid, desc->productid.c_str());
+	AddStringProp(nodeobj, type, desc->type.c_str());
+	AddStringProp(nodeobj, name, desc->name.c_str());
+	AddStringProp(nodeobj, loc, desc->loc.c_str());
 }
 
-void populateValueId(v8::Local<v8::Object> &nodeobj, OpenZWave::ValueID value)
+// the metadata properties of a value object
+static void setValueMetadata(v8::Local<v8::Object> &nodeobj, ValueState const &vs)
+{
+	Nan::Set(nodeobj, Nan::New<String>("label").ToLocalChecked(), vs.label.v8str());
+	Nan::Set(nodeobj, Nan::New<String>("units").ToLocalChecked(), vs.units.v8str());
+	Nan::Set(nodeobj, Nan::New<String>("help").ToLocalChecked(), vs.help.v8str());
+	AddBooleanProp(nodeobj, read_only, vs.read_only);
+	AddBooleanProp(nodeobj, write_only, vs.write_only);
+	AddIntegerProp(nodeobj, min, vs.min);
+	AddIntegerProp(nodeobj, max, vs.max);
+	AddBooleanProp(nodeobj, is_polled, vs.polled);
+}
+
+void populateValueId(v8::Local<v8::Object> &nodeobj, OpenZWave::ValueID value, uint32 fields, ValueInfo *vinfo)
 {
 	Nan::EscapableHandleScope handle_scope;
 	::std::string buffer = getValueIdDescriptor(value);
@@ -324,52 +1092,129 @@ void populateValueId(v8::Local<v8::Object> &nodeobj, OpenZWave::ValueID value)
 	//Nan::Set(valobj, Nan::New<String>("id"), Nan::New<Integer>(value.GetId()));
 	//Nan::Set(valobj, Nan::New<String>("change_verified").ToLocalChecked(), Nan::New<Boolean>(mgr->GetChangeVerified(value))->ToBoolean());
 	//
-	AddStringProp(nodeobj, value_id, buffer.c_str());
-	AddIntegerProp(nodeobj, node_id, value.GetNodeId());
-	AddIntegerProp(nodeobj, class_id, value.GetCommandClassId());
+	if (fields & ValueField_Id)
+	{
+		AddStringProp(nodeobj, value_id, buffer.c_str());
+		AddIntegerProp(nodeobj, node_id, value.GetNodeId());
+		AddIntegerProp(nodeobj, class_id, value.GetCommandClassId());
 #if OPENZWAVE_VALUETYPE_FROM_VALUEID
-	AddStringProp(nodeobj, type, value.GetTypeAsString());
-	AddStringProp(nodeobj, genre, value.GetGenreAsString());
+		AddStringProp(nodeobj, type, value.GetTypeAsString());
+		AddStringProp(nodeobj, genre, value.GetGenreAsString());
 #elif OPENZWAVE_VALUETYPE_FROM_ENUM
-	AddStringProp(nodeobj, type, OpenZWave::Value::GetTypeNameFromEnum(value.GetType()));
-	AddStringProp(nodeobj, genre, OpenZWave::Value::GetGenreNameFromEnum(value.GetGenre()));
+		AddStringProp(nodeobj, type, OpenZWave::Value::GetTypeNameFromEnum(value.GetType()));
+		AddStringProp(nodeobj, genre, OpenZWave::Value::GetGenreNameFromEnum(value.GetGenre()));
 #else
-	AddIntegerProp(nodeobj, type, value.GetType());
-	AddIntegerProp(nodeobj, genre, value.GetGenre());
+		AddIntegerProp(nodeobj, type, value.GetType());
+		AddIntegerProp(nodeobj, genre, value.GetGenre());
 #endif
-	AddIntegerProp(nodeobj, instance, value.GetInstance());
-	AddIntegerProp(nodeobj, index, value.GetIndex());
+		AddIntegerProp(nodeobj, instance, value.GetInstance());
+		AddIntegerProp(nodeobj, index, value.GetIndex());
+	}
+	if (!(fields & ValueField_Metadata))
+	{
+		return;
+	}
 
+	ValueInfo tmpinfo(value);
+	if (!vinfo)
+	{
+		vinfo = &tmpinfo;
+	}
+	fetch_value_metadata(vinfo);
+	setValueMetadata(nodeobj, ValueState(vinfo));
+}
+
+/*
+	* Read the static metadata of a value from OpenZWave, unless already
+	* cached (or loaded from the warm start file).
+	*/
+void fetch_value_metadata(ValueInfo *vinfo)
+{
+	if (vinfo->meta_cached)
+	{
+		return;
+	}
 	::std::string helpVal, labelVal, unitsVal;
-	bool read_onlyVal = false, write_onlyVal = false, is_polledVal = false;
-	int32 minVal = 0, maxVal = 0;
-
-	OZWManagerAssign(labelVal, GetValueLabel, value);
-	OZWManagerAssign(unitsVal, GetValueUnits, value);
-	OZWManagerAssign(helpVal, GetValueHelp, value);
-	OZWManagerAssign(read_onlyVal, IsValueReadOnly, value);
-	OZWManagerAssign(write_onlyVal, IsValueWriteOnly, value);
-	OZWManagerAssign(minVal, GetValueMin, value);
-	OZWManagerAssign(maxVal, GetValueMax, value);
-	OZWManagerAssign(is_polledVal, IsValuePolled, value);
-
-	AddStringProp(nodeobj, label, labelVal);
-	AddStringProp(nodeobj, units, unitsVal);
-	AddStringProp(nodeobj, help, helpVal);
-	AddBooleanProp(nodeobj, read_only, read_onlyVal);
-	AddBooleanProp(nodeobj, write_only, write_onlyVal);
-	AddIntegerProp(nodeobj, min, minVal);
-	AddIntegerProp(nodeobj, max, maxVal);
-	AddBooleanProp(nodeobj, is_polled, is_polledVal);
+	OZWManagerAssign(labelVal, GetValueLabel, vinfo->id);
+	OZWManagerAssign(unitsVal, GetValueUnits, vinfo->id);
+	OZWManagerAssign(helpVal, GetValueHelp, vinfo->id);
+	OZWManagerAssign(vinfo->read_only, IsValueReadOnly, vinfo->id);
+	OZWManagerAssign(vinfo->write_only, IsValueWriteOnly, vinfo->id);
+	OZWManagerAssign(vinfo->min, GetValueMin, vinfo->id);
+	OZWManagerAssign(vinfo->max, GetValueMax, vinfo->id);
+	OZWManagerAssign(vinfo->polled, IsValuePolled, vinfo->id);
+	vinfo->label = InternedString(labelVal);
+	vinfo->units = InternedString(unitsVal);
+	vinfo->help  = InternedString(helpVal);
+	vinfo->meta_cached = true;
+}
+
+// cache the metadata captured with a value's notification
+void set_value_metadata(ValueInfo *vinfo, CachedMetadata const &meta)
+{
+	vinfo->label      = InternedString(meta.label);
+	vinfo->units      = InternedString(meta.units);
+	vinfo->help       = InternedString(meta.help);
+	vinfo->read_only  = meta.read_only;
+	vinfo->write_only = meta.write_only;
+	vinfo->min        = meta.min;
+	vinfo->max        = meta.max;
+	vinfo->polled     = meta.polled;
+	vinfo->meta_cached = true;
 }
 
 // create a V8 object from a OpenZWave::ValueID
-Local<Object> zwaveValue2v8Value(OpenZWave::ValueID value)
+Local<Object> zwaveValue2v8Value(OpenZWave::ValueID value, uint32 fields, ValueInfo *vinfo)
+{
+	if (vinfo)
+	{
+		ValueState vs(vinfo);
+		return valueState2v8Value(vs, fields);
+	}
+	Nan::EscapableHandleScope handle_scope;
+	Local<Object> valobj = Nan::New<Object>();
+	populateValueId(valobj, value, fields);
+	if (fields & ValueField_Value)
+	{
+		setValObj(valobj, value, fields, NULL);
+	}
+	return handle_scope.Escape(valobj);
+}
+
+/*
+	* Create a V8 object from the copied state of a known value, without
+	* holding znodes_mutex: only what isn't cached (yet) is asked from OpenZWave.
+	*/
+Local<Object> valueState2v8Value(ValueState &vs, uint32 fields)
 {
 	Nan::EscapableHandleScope handle_scope;
 	Local<Object> valobj = Nan::New<Object>();
-	populateValueId(valobj, value);
-	setValObj(valobj, value);
+	populateValueId(valobj, vs.id, fields & ValueField_Id);
+	if ((fields & ValueField_Metadata) && vs.meta_cached)
+	{
+		setValueMetadata(valobj, vs);
+	}
+	else if (fields & ValueField_Metadata)
+	{
+		// fetched once, and kept in the ValueInfo from then on
+		fetch_value_metadata(vs.vinfo);
+		setValueMetadata(valobj, ValueState(vs.vinfo));
+	}
+	if ((fields & ValueField_Value) && vs.stale)
+	{
+		// not known to OpenZWave (yet), only the warm start contents are
+		Nan::Set(valobj, Nan::New<String>("value").ToLocalChecked(),
+			cachedValue2v8Value(vs.id, vs.cache.get()));
+		AddBooleanProp(valobj, stale, true);
+	}
+	else if ((fields & ValueField_Value) && vs.cache && vs.cache->valid)
+	{
+		setCachedValObj(valobj, vs.id, fields, vs.vinfo, vs.cache.get());
+	}
+	else if (fields & ValueField_Value)
+	{
+		setValObj(valobj, vs.id, fields, vs.vinfo);
+	}
 	return handle_scope.Escape(valobj);
 }
 
@@ -379,7 +1224,7 @@ Local<Object> zwaveSceneValue2v8Value(uint8 sceneId, OpenZWave::ValueID value)
 {
 	Nan::EscapableHandleScope handle_scope;
 	Local<Object> valobj = Nan::New<Object>();
-	populateValueId(valobj, value);
+	populateValueId(valobj, value, ValueField_All);
 	setSceneValObj(sceneId, valobj, value);
 	return handle_scope.Escape(valobj);
 }
@@ -400,7 +1245,7 @@ bool isOzwValue(Local<Object> &o)
 		instance: the instance of the command (usually 1)
 		index: the index of the command (usually 0)
 */
-OpenZWave::ValueID *populateValueId(const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 offset)
+ValueInfo *populateValueInfo(const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 offset)
 {
 	uint8 nodeid, comclass, instance;
 	OZWValueIdIndex index;
@@ -444,13 +1289,15 @@ OpenZWave::ValueID *populateValueId(const Nan::FunctionCallbackInfo<v8::Value> &
 	}
 
 	NodeInfo *node = NULL;
-	::std::list<OpenZWave::ValueID>::iterator vit;
+	::std::list<ValueInfo>::iterator vit;
 
 	if ((node = get_node_info(nodeid)))
 	{
+		// like get_value_info(), the value list is walked under the lock
+		mutex::scoped_lock sl(znodes_mutex);
 		for (vit = node->values.begin(); vit != node->values.end(); ++vit)
 		{
-			if (((*vit).GetCommandClassId() == comclass) && ((*vit).GetInstance() == instance) && ((*vit).GetIndex() == index))
+			if ((vit->id.GetCommandClassId() == comclass) && (vit->id.GetInstance() == instance) && (vit->id.GetIndex() == index))
 			{
 				return (&*vit);
 			}
@@ -463,6 +1310,27 @@ OpenZWave::ValueID *populateValueId(const Nan::FunctionCallbackInfo<v8::Value> &
 	return (NULL);
 }
 
+OpenZWave::ValueID *populateValueId(const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 offset)
+{
+	ValueInfo *vinfo = populateValueInfo(info, offset);
+	return (vinfo ? &vinfo->id : NULL);
+}
+
+/* get the native value from a handle previously returned by resolveValue() */
+ValueInfo *populateValueHandle(const Nan::FunctionCallbackInfo<v8::Value> &info, uint8 offset)
+{
+	ValueInfo *vinfo = NULL;
+	if ((info.Length() > offset) && info[offset]->IsNumber())
+	{
+		vinfo = get_value_by_handle(Nan::To<uint32_t>(info[offset]).FromJust());
+	}
+	if (!vinfo)
+	{
+		Nan::ThrowTypeError("OpenZWave value handle not found, please use resolveValue() to obtain a valid one");
+	}
+	return (vinfo);
+}
+
 const char *getControllerStateAsStr(OpenZWave::Driver::ControllerState _state)
 {
 	switch (_state)
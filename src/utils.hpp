@@ -59,6 +59,11 @@ OZWValueIdIndex;
 		Nan::New<v8::String>( #PROPNAME ).ToLocalChecked(),  \
 		Nan::New<v8::Integer>( PROPVALUE ));
 
+#define AddNumberProp(OBJ,PROPNAME,PROPVALUE) \
+	Nan::Set(OBJ,                                \
+		Nan::New<v8::String>( #PROPNAME ).ToLocalChecked(),  \
+		Nan::New<v8::Number>( PROPVALUE ));
+
 #define AddBooleanProp(OBJ,PROPNAME,PROPVALUE) \
 	Nan::Set(OBJ,                                \
 		Nan::New<v8::String>( #PROPNAME ).ToLocalChecked(),  \
@@ -72,7 +77,7 @@ OZWValueIdIndex;
 #define AddArrayOfStringProp(OBJ,PROPNAME,PROPVALUE) \
 	Local < Array > PROPNAME = Nan::New<Array>(PROPVALUE.size()); \
 	for (unsigned int i = 0; i < PROPVALUE.size(); i++) { \
-		Nan::Set(values, i, Nan::New<String>(   \
+		Nan::Set(PROPNAME, i, Nan::New<String>(   \
 			&PROPVALUE[i][0], PROPVALUE[i].size() \
 		).ToLocalChecked()); \
 	} \
@@ -129,9 +134,119 @@ namespace OZW {
 
 namespace OZW {
 
-	v8::Local<v8::Object> zwaveValue2v8Value(OpenZWave::ValueID value);
+	// which properties of a value object to fill in, see ValueFields in lib/enums.ts
+	enum ValueFields {
+		ValueField_Id       = 0x01, // value_id, node_id, class_id, type, genre, instance, index
+		ValueField_Metadata = 0x02, // label, units, help, read_only, write_only, min, max, is_polled
+		ValueField_Value    = 0x04, // the current value
+		ValueField_Items    = 0x08, // BitSet: per-bit labels and help, List: all items
+		ValueField_All      = 0x0F
+	};
+
+	// which properties of a node object to fill in, see NodeFields in lib/enums.ts
+	enum NodeFields {
+		NodeField_Names    = 0x01, // manufacturer, manufacturerid, product, producttype, productid, type, name, loc
+		NodeField_Protocol = 0x02, // listening, frequent_listening, beaming, routing, security_device, max_baud_rate, version, security, basic, generic, specific
+		NodeField_Type     = 0x04, // device_type, device_type_string, role, role_string, plus_type, plus_type_string
+		NodeField_Status   = 0x08, // failed, awake, info_received, query_stage, polled
+		NodeField_All      = 0x0F
+	};
+
+	v8::Local<v8::Object> zwaveValue2v8Value(OpenZWave::ValueID value, uint32 fields = ValueField_All, ValueInfo *vinfo = NULL);
+	v8::Local<v8::Object> valueState2v8Value(ValueState &vs, uint32 fields);
 	NodeInfo  *get_node_info(uint8 nodeid);
+	void       publish_node(NodeInfo *node);
 	void       delete_node(uint8 nodeid);
+	void       reclaim_nodes();
+	void       clear_nodes();
+	uint32     get_node_handle(NodeInfo const *node);
+	NodeInfo  *get_node_by_handle(uint32 handle);
+	void       refresh_node_names(NodeDescriptor &desc, uint32 homeid, uint8 nodeid);
+	void       refresh_node_protocol(NodeDescriptor &desc, uint32 homeid, uint8 nodeid);
+	NodeDescriptor *get_node_descriptor(uint8 nodeid, bool protocol);
+	void       refresh_node_classes(NodeDescriptor &desc, uint32 homeid, uint8 nodeid, bool complete);
+	NodeDescriptor *get_node_classes(uint8 nodeid);
+	::std::string const &get_class_name(uint8 cc);
+#if OPENZWAVE_16
+	void       refresh_node_metadata(NodeDescriptor &desc, uint32 homeid, uint8 nodeid);
+	void       set_metadata_ready(bool ready);
+	NodeDescriptor *get_node_metadata(uint8 nodeid);
+#endif
+	void       release_value(ValueInfo *vinfo);
+	// value handles, caller must hold znodes_mutex when adding/removing
+	void       add_value_handle(ValueInfo *vinfo);
+	void       remove_value_handle(ValueInfo *vinfo);
+	ValueInfo *get_value_by_handle(uint32 handle);
+	ValueInfo *get_value_info(OpenZWave::ValueID const &value);
+	void       fetch_value_metadata(ValueInfo *vinfo);
+	void       set_value_metadata(ValueInfo *vinfo, CachedMetadata const &meta);
+	void       captureValue(OpenZWave::ValueID const &value, CachedValue &cache);
+	void       captureMetadata(OpenZWave::ValueID const &value, CachedMetadata &meta);
+	v8::Local<v8::Value> cachedValue2v8Value(OpenZWave::ValueID const &value, CachedValue const *cache);
+	bool       cachedValueAsDouble(OpenZWave::ValueID const &value, CachedValue const *cache, double *o_value);
+	bool       cachedValueEquals(OpenZWave::ValueID const &value, CachedValue const *a, CachedValue const *b);
+	v8::Local<v8::ArrayBuffer> newExternalArrayBuffer(size_t bytes, void **data);
+	double     nowMsec();
+	const ::std::vector< ::std::string > &get_value_list_items(ValueInfo *vinfo);
+	// intern table (openzwave-strings.cc)
+	void       intern_table_usage(uint32 *strings, uint64 *bytes, uint32 *v8handles);
+	// change tracking (openzwave-changes.cc), caller must hold znodes_mutex
+	uint64     get_value_seq();
+	void       touch_value(ValueInfo *vinfo);
+	void       forget_value(ValueInfo *vinfo);
+	// change event filtering (openzwave-filters.cc)
+	bool       value_filtered(ValueInfo *vinfo);
+	void       value_emitted(ValueInfo *vinfo, CachedValue const *cache);
+	bool       event_throttled(ThrottleInfo *throttle, NotifInfo *notif,
+		::std::shared_ptr<const CachedValue> const &value = ::std::shared_ptr<const CachedValue>());
+	void       release_throttle(ThrottleInfo *throttle);
+	// value history (openzwave-history.cc)
+	void       history_record(ValueInfo *vinfo, double ts);
+	// meter accumulation (openzwave-meters.cc)
+	void       meter_record(ValueInfo *vinfo, double ts);
+	bool       meter_quiet(ValueInfo *vinfo);
+	// value table (openzwave-valuetable.cc), caller must hold znodes_mutex when adding/removing
+	void       value_table_add(ValueInfo *vinfo);
+	void       value_table_update(ValueInfo *vinfo);
+	void       value_table_remove(ValueInfo *vinfo);
+	uint32     value_table_capacity();
+	// startup profiling (openzwave-profile.cc)
+	enum DriverStage {
+		DriverStage_Connect = 0,
+		DriverStage_DriverReady,
+		DriverStage_AwakeNodesQueried,
+		DriverStage_AllNodesQueried,
+		DriverStage_Count
+	};
+	enum NodeStage {
+		NodeStage_Added = 0,
+		NodeStage_ProtocolInfo,
+		NodeStage_EssentialQueriesComplete,
+		NodeStage_QueriesComplete,
+		NodeStage_Count
+	};
+	void       profile_driver_stage(uint8 stage, double ts);
+	void       profile_node_stage(uint8 nodeid, uint8 stage, double ts);
+	// memory accounting (openzwave-memory.cc)
+	void       memory_count_notif(NotifInfo const *notif, bool allocated);
+	void       memory_count_node(bool allocated);
+	// node liveness (openzwave-liveness.cc)
+	enum NodeLiveness {
+		NodeLiveness_Unknown = 0,
+		NodeLiveness_Alive,
+		NodeLiveness_Awake,
+		NodeLiveness_Asleep,
+		NodeLiveness_Dead
+	};
+	void       liveness_record(NotifInfo *notif);
+	void       liveness_clear();
+	uint8      get_node_liveness(uint8 nodeid);
+	// warm start (openzwave-warmstart.cc), caller must hold znodes_mutex for find_stale_value
+	ValueInfo *find_stale_value(NodeInfo *node, OpenZWave::ValueID const &value);
+	void       drop_stale(int nodeid);
+	void       warmstart_start(::std::string const &userpath);
+	void       warmstart_stop();
+	void       warmstart_save();
 
 #ifdef OPENZWAVE16_DEPRECATED
 	v8::Local<v8::Object> zwaveSceneValue2v8Value(uint8 sceneId, OpenZWave::ValueID value);
@@ -139,7 +254,11 @@ namespace OZW {
 #endif
 
 	OpenZWave::ValueID* populateValueId(const Nan::FunctionCallbackInfo<v8::Value>& info, uint8 offset=0);
+	ValueInfo* populateValueInfo(const Nan::FunctionCallbackInfo<v8::Value>& info, uint8 offset=0);
+	ValueInfo* populateValueHandle(const Nan::FunctionCallbackInfo<v8::Value>& info, uint8 offset=0);
 	void populateNode(v8::Local<v8::Object>& nodeobj, uint32 homeid, uint8 nodeid);
+	void populateValueId(v8::Local<v8::Object>& nodeobj, OpenZWave::ValueID value, uint32 fields, ValueInfo *vinfo = NULL);
+	::std::string getValueIdDescriptor(OpenZWave::ValueID value);
 	const char* getControllerStateAsStr (OpenZWave::Driver::ControllerState _state);
 	const char* getControllerErrorAsStr(OpenZWave::Driver::ControllerError _err);
 
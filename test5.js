@@ -0,0 +1,566 @@
+var assert = require('assert');
+var OpenZWave = require('./lib/openzwave-shared.js');
+// like test.js, this test assumes no actual ZWave controller exists on the system:
+// it drives the native state through synthetic notifications (see _injectNotification)
+var zwave = new OpenZWave()
+
+var failed = 0
+function check(name, fn) {
+  try {
+    fn()
+    console.log('ok', name)
+  } catch (e) {
+    failed++
+    console.log('FAILED', name, e)
+  }
+}
+
+// the checks that need the event loop, run one after the other once the
+// synchronous ones are done. fn gets a callback to call (with an error if
+// it failed) when it's through
+var asyncChecks = []
+function checkAsync(name, fn) {
+  asyncChecks.push({ name: name, fn: fn })
+}
+
+function runAsyncChecks(finish) {
+  var c = asyncChecks.shift()
+  if (!c) {
+    return finish()
+  }
+  var timer
+  function done(e) {
+    clearTimeout(timer)
+    if (e) {
+      failed++
+      console.log('FAILED', c.name, e)
+    } else {
+      console.log('ok', c.name)
+    }
+    runAsyncChecks(finish)
+  }
+  timer = setTimeout(function () { done(new Error('timed out')) }, 5000)
+  try {
+    c.fn(done)
+  } catch (e) {
+    done(e)
+  }
+}
+
+// notification types, as in OpenZWave::Notification::NotificationType
+var Notif = {
+  ValueAdded: 0,
+  ValueRemoved: 1,
+  ValueChanged: 2,
+  ValueRefreshed: 3,
+  NodeAdded: 6,
+  NodeRemoved: 7,
+  NodeEvent: 10,
+  PollingDisabled: 11,
+  PollingEnabled: 12,
+  Notification: 26
+}
+
+// the events 'name' emitted while running fn, as arrays of their arguments
+function emitted(name, fn) {
+  var events = []
+  function listener() {
+    events.push(Array.prototype.slice.call(arguments))
+  }
+  zwave.on(name, listener)
+  try {
+    fn()
+  } finally {
+    zwave.removeListener(name, listener)
+  }
+  return events
+}
+
+// a node with a single value, fed through the notification handler
+function addValue(nodeid, value) {
+  zwave._injectNotification(Notif.NodeAdded, nodeid)
+  zwave._injectNotification(Notif.ValueAdded, nodeid, value)
+}
+
+var valueId = { node_id: 2, class_id: 49, instance: 1, index: 1 }
+
+check('value handles', function () {
+  assert.throws(function () { zwave.resolveValue(valueId) }, TypeError)
+  assert.throws(function () { zwave.getValueByHandle(0) }, TypeError)
+  assert.throws(function () { zwave.getValueByHandle(0x100001) }, TypeError)
+  assert.throws(function () { zwave.setValueByHandle(0x100001, 1) }, TypeError)
+  assert.throws(function () { zwave.refreshValueByHandle(0x100001) }, TypeError)
+})
+
+check('node handles', function () {
+  assert.strictEqual(zwave.resolveNode(2), undefined)
+  assert.strictEqual(zwave.getNodeInfoByHandle(0x1000002), undefined)
+  assert.strictEqual(zwave.getNodeInfo(2), undefined)
+  assert.deepStrictEqual(zwave.getNodes(), [])
+})
+
+check('value table', function () {
+  assert.throws(function () { zwave.enableValueTable(0) }, RangeError)
+  assert.throws(function () { zwave.enableValueTable(0x100000) }, RangeError)
+  var table = zwave.enableValueTable(16)
+  assert(table.values instanceof Float64Array)
+  assert(table.handles instanceof Uint32Array)
+  assert(table.generations instanceof Uint32Array)
+  assert.strictEqual(table.values.length, 16)
+  for (var i = 0; i < 16; i++) {
+    assert.strictEqual(table.handles[i], 0)
+    assert(isNaN(table.values[i]))
+  }
+  assert.strictEqual(zwave.getMemoryStats().valueTable.count, 16)
+  zwave.disableValueTable()
+  assert.strictEqual(zwave.getMemoryStats().valueTable.count, 0)
+})
+
+check('changesSince', function () {
+  var delta = zwave.changesSince(0)
+  assert.strictEqual(delta.seq, 0)
+  assert.strictEqual(delta.reset, false)
+  assert.deepStrictEqual(delta.values, [])
+  assert.deepStrictEqual(delta.removed, [])
+  // a sequence number from before a restart
+  delta = zwave.changesSince(1000)
+  assert.strictEqual(delta.reset, true)
+  assert.strictEqual(delta.seq, 0)
+})
+
+check('snapshot', function () {
+  var snap = zwave.snapshot()
+  assert.strictEqual(snap.seq, 0)
+  assert.deepStrictEqual(snap.getNodeIds(), [])
+  assert.deepStrictEqual(snap.getValues(), [])
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(snap)), { seq: 0, values: [] })
+  assert.throws(function () { snap.toJSON.call({}) }, TypeError)
+  assert.throws(function () { snap.getValues.call(zwave) }, TypeError)
+})
+
+check('deadband and throttle', function () {
+  assert.throws(function () { zwave.setDeadband(valueId, { absolute: 1 }) }, TypeError)
+  assert.throws(function () { zwave.throttle(valueId, 100) }, TypeError)
+  assert.throws(function () { zwave.throttle(2, 100) }, Error)
+  assert.deepStrictEqual(zwave.getDeadbandStats(), { suppressed: 0, values: {} })
+})
+
+check('history', function () {
+  assert.throws(function () { zwave.recordHistory(valueId) }, TypeError)
+  assert.throws(function () { zwave.queryHistory(valueId, 0, 1000, 10) }, TypeError)
+})
+
+check('meters', function () {
+  zwave.trackMeters(true, { suppressEvents: true })
+  assert.deepStrictEqual(zwave.getMeterSummary(), {})
+  zwave.trackMeters(false)
+})
+
+check('memory stats', function () {
+  var stats = zwave.getMemoryStats()
+  assert.strictEqual(stats.nodes.count, 0)
+  assert.strictEqual(stats.values.count, 0)
+  assert.strictEqual(stats.queue.count, 0)
+  assert.strictEqual(typeof stats.persistentHandles, 'number')
+  assert.strictEqual(typeof stats.notifications, 'object')
+})
+
+check('startup profile', function () {
+  assert.deepStrictEqual(zwave.getStartupProfile(), { driver: {}, nodes: [] })
+})
+
+check('liveness', function () {
+  var l = zwave.getLiveness()
+  assert(l.status instanceof Uint8Array)
+  assert(l.lastSeen instanceof Float64Array)
+  assert.strictEqual(l.status.length, 256)
+  assert.strictEqual(l.lastSeen.length, 256)
+  for (var i = 0; i < 256; i++) {
+    assert.strictEqual(l.status[i], OpenZWave.NodeLiveness.Unknown)
+    assert.strictEqual(l.lastSeen[i], 0)
+  }
+  assert.throws(function () { zwave.setSilenceThreshold(-1) }, RangeError)
+  assert.throws(function () { zwave.setSilenceThreshold(4294968) }, RangeError)
+  zwave.setSilenceThreshold(600)
+  zwave.setSilenceThreshold(0)
+})
+
+// from here on, the native state is driven through synthetic notifications
+
+check('value objects from the cached contents', function () {
+  var temp = { class_id: 49, instance: 1, index: 1, type: 'decimal', value: 21.7, precision: 1, label: 'Temperature', units: 'C' }
+  var added = emitted('value added', function () {
+    addValue(10, temp)
+  })
+  assert.strictEqual(added.length, 1)
+  assert.strictEqual(added[0][0], 10)
+  assert.strictEqual(added[0][1], 49)
+  assert.strictEqual(added[0][2].value_id, '10-49-1-1')
+  assert.strictEqual(added[0][2].label, 'Temperature')
+  assert.strictEqual(added[0][2].units, 'C')
+  assert.strictEqual(added[0][2].value, '21.7')
+  var changed = emitted('value changed', function () {
+    zwave._injectNotification(Notif.ValueChanged, 10, Object.assign({}, temp, { value: 22.25, precision: 2 }))
+  })
+  assert.strictEqual(changed.length, 1)
+  assert.strictEqual(changed[0][2].value, '22.25')
+  // the metadata is kept from 'value added'
+  assert.strictEqual(changed[0][2].label, 'Temperature')
+  var refreshed = emitted('value refreshed', function () {
+    zwave._injectNotification(Notif.ValueRefreshed, 10, Object.assign({}, temp, { value: 22.5 }))
+  })
+  assert.strictEqual(refreshed[0][2].value, '22.5')
+  assert.strictEqual(zwave.getValue({ node_id: 10, class_id: 49, instance: 1, index: 1 }), '22.5')
+})
+
+check('value handles of known values', function () {
+  var level = { class_id: 38, instance: 1, index: 0, type: 'byte', value: 50 }
+  addValue(11, level)
+  var vid = { node_id: 11, class_id: 38, instance: 1, index: 0 }
+  var h = zwave.resolveValue(vid)
+  assert.strictEqual(typeof h, 'number')
+  assert.notStrictEqual(h, 0)
+  // the same handle for the same value, also in the legacy argument form
+  assert.strictEqual(zwave.resolveValue(11, 38, 1, 0), h)
+  assert.strictEqual(zwave.getValueByHandle(h), 50)
+  zwave._injectNotification(Notif.ValueChanged, 11, Object.assign({}, level, { value: 99 }))
+  assert.strictEqual(zwave.getValueByHandle(h), 99)
+  // a second value of the node gets a handle of its own
+  zwave._injectNotification(Notif.ValueAdded, 11, { class_id: 37, instance: 1, index: 0, type: 'bool', value: true })
+  var h2 = zwave.resolveValue({ node_id: 11, class_id: 37, instance: 1, index: 0 })
+  assert.notStrictEqual(h2, h)
+  assert.strictEqual(zwave.getValueByHandle(h2), true)
+  // gone with the value: the xxxByHandle calls reject it
+  zwave._injectNotification(Notif.ValueRemoved, 11, level)
+  assert.throws(function () { zwave.resolveValue(vid) }, TypeError)
+  assert.throws(function () { zwave.getValueByHandle(h) }, TypeError)
+  assert.throws(function () { zwave.setValueByHandle(h, 1) }, TypeError)
+  assert.throws(function () { zwave.refreshValueByHandle(h) }, TypeError)
+  assert.strictEqual(zwave.getValueByHandle(h2), true)
+})
+
+check('bulk value queries', function () {
+  addValue(12, { class_id: 37, instance: 1, index: 0, type: 'bool', value: false, label: 'Switch' })
+  zwave._injectNotification(Notif.ValueAdded, 12, { class_id: 50, instance: 1, index: 0, type: 'int', value: 1234, label: 'Energy', units: 'kWh' })
+  var values = zwave.getValues(12)
+  assert.deepStrictEqual(values.map(function (v) { return v.value_id }), ['12-37-1-0', '12-50-1-0'])
+  assert.strictEqual(values[0].label, 'Switch')
+  assert.strictEqual(values[0].value, false)
+  assert.strictEqual(values[1].units, 'kWh')
+  assert.strictEqual(values[1].value, 1234)
+  // only the fields asked for
+  values = zwave.getValues(12, OpenZWave.ValueFields.Id | OpenZWave.ValueFields.Value)
+  assert.strictEqual(values[1].value_id, '12-50-1-0')
+  assert.strictEqual(values[1].value, 1234)
+  assert(!('label' in values[1]))
+  values = zwave.getValues(12, OpenZWave.ValueFields.Value)
+  assert.deepStrictEqual(values, [{ value: false }, { value: 1234 }])
+  assert.deepStrictEqual(zwave.getValues(13), [])
+  // and across all nodes
+  var all = zwave.getAllValues(OpenZWave.ValueFields.Id).map(function (v) { return v.value_id })
+  assert(all.indexOf('12-37-1-0') >= 0)
+  assert(all.indexOf('12-50-1-0') >= 0)
+  assert(all.indexOf('10-49-1-1') >= 0)
+})
+
+check('decimals as doubles', function () {
+  var table = zwave.enableValueTable(64)
+  addValue(14, { class_id: 49, instance: 1, index: 1, type: 'decimal', value: 21.7, precision: 1 })
+  var slot = table.handles.indexOf(zwave.resolveValue(14, 49, 1, 1))
+  assert(slot >= 0)
+  // not the float's 21.700000762939453
+  assert.strictEqual(table.values[slot], 21.7)
+  zwave._injectNotification(Notif.ValueChanged, 14, { class_id: 49, instance: 1, index: 1, type: 'decimal', value: 0.35, precision: 2 })
+  assert.strictEqual(table.values[slot], 0.35)
+  zwave.disableValueTable()
+})
+
+check('changes since a sequence number', function () {
+  var level = { class_id: 38, instance: 1, index: 0, type: 'byte', value: 1 }
+  var seq = zwave.changesSince(0).seq
+  addValue(15, level)
+  var delta = zwave.changesSince(seq)
+  assert.strictEqual(delta.reset, false)
+  assert(delta.seq > seq)
+  assert.deepStrictEqual(delta.values.map(function (v) { return v.value_id }), ['15-38-1-0'])
+  assert.strictEqual(delta.values[0].value, 1)
+  seq = delta.seq
+  assert.deepStrictEqual(zwave.changesSince(seq).values, [])
+  // a refresh that brings the same value isn't a change, another one is
+  zwave._injectNotification(Notif.ValueRefreshed, 15, level)
+  assert.deepStrictEqual(zwave.changesSince(seq).values, [])
+  zwave._injectNotification(Notif.ValueRefreshed, 15, Object.assign({}, level, { value: 2 }))
+  delta = zwave.changesSince(seq)
+  assert.strictEqual(delta.values.length, 1)
+  assert.strictEqual(delta.values[0].value, 2)
+  seq = delta.seq
+  zwave._injectNotification(Notif.ValueRemoved, 15, level)
+  delta = zwave.changesSince(seq)
+  assert.deepStrictEqual(delta.values, [])
+  assert.deepStrictEqual(delta.removed, ['15-38-1-0'])
+  // a sequence number from before a restart
+  assert.strictEqual(zwave.changesSince(delta.seq + 1).reset, true)
+})
+
+check('snapshots stay put', function () {
+  var level = { class_id: 38, instance: 1, index: 0, type: 'byte', value: 10 }
+  addValue(16, level)
+  var snap = zwave.snapshot()
+  assert(snap.getNodeIds().indexOf(16) >= 0)
+  assert.deepStrictEqual(snap.getValues(16).map(function (v) { return v.value }), [10])
+  // later changes, additions and removals don't show in it
+  zwave._injectNotification(Notif.ValueChanged, 16, Object.assign({}, level, { value: 20 }))
+  zwave._injectNotification(Notif.ValueAdded, 16, { class_id: 37, instance: 1, index: 0, type: 'bool', value: true })
+  assert.strictEqual(zwave.getValue({ node_id: 16, class_id: 38, instance: 1, index: 0 }), 20)
+  assert.deepStrictEqual(snap.getValues(16).map(function (v) { return v.value }), [10])
+  zwave._injectNotification(Notif.NodeRemoved, 16)
+  assert.deepStrictEqual(snap.getValues(16).map(function (v) { return v.value_id }), ['16-38-1-0'])
+  assert.strictEqual(snap.toJSON().seq, snap.seq)
+  assert(zwave.snapshot().seq > snap.seq)
+  assert.strictEqual(zwave.snapshot().getNodeIds().indexOf(16), -1)
+})
+
+check('deadband filtering', function () {
+  var power = { class_id: 49, instance: 1, index: 4, type: 'int', value: 100 }
+  var vid = { node_id: 17, class_id: 49, instance: 1, index: 4 }
+  function change(value) {
+    return emitted('value changed', function () {
+      zwave._injectNotification(Notif.ValueChanged, 17, Object.assign({}, power, { value: value }))
+    }).length
+  }
+  addValue(17, power)
+  zwave.setDeadband(vid, { absolute: 5 })
+  assert.strictEqual(change(103), 0)
+  // suppressed, but the native state follows
+  assert.strictEqual(zwave.getValue(vid), 103)
+  assert.strictEqual(change(105), 1)
+  // measured from the last emitted value, 105
+  assert.strictEqual(change(108), 0)
+  assert.strictEqual(change(101), 0)
+  assert.strictEqual(change(100), 1)
+  var stats = zwave.getDeadbandStats()
+  assert.strictEqual(stats.values['17-49-1-4'], 3)
+  assert(stats.suppressed >= 3)
+  // the current value is the reference of a new deadband
+  zwave.setDeadband(vid, { relative: 0.1 })
+  assert.strictEqual(change(109), 0)
+  assert.strictEqual(change(90), 1)
+  zwave.setDeadband(vid, null)
+  assert.strictEqual(change(91), 1)
+  assert(!('17-49-1-4' in zwave.getDeadbandStats().values))
+  zwave._injectNotification(Notif.ValueAdded, 17, { class_id: 37, instance: 1, index: 0, type: 'bool', value: true })
+  assert.throws(function () { zwave.setDeadband({ node_id: 17, class_id: 37, instance: 1, index: 0 }, { absolute: 1 }) }, TypeError)
+})
+
+check('history buckets', function () {
+  var temp = { class_id: 49, instance: 1, index: 1, type: 'decimal', value: 20, precision: 1 }
+  var vid = { node_id: 19, class_id: 49, instance: 1, index: 1 }
+  function sample(value, ts) {
+    zwave._injectNotification(Notif.ValueChanged, 19, Object.assign({}, temp, { value: value }), ts)
+  }
+  addValue(19, temp)
+  assert.throws(function () { zwave.queryHistory(vid, 0, 1000, 100) }, Error)
+  zwave.recordHistory(vid, { capacity: 4 })
+  sample(21, 1000)
+  sample(23, 1500)
+  sample(22, 2100)
+  var h = zwave.queryHistory(vid, 1000, 3000, 1000)
+  assert.deepStrictEqual(Array.from(h.timestamps), [1000, 2000])
+  assert.deepStrictEqual(Array.from(h.count), [2, 1])
+  assert.deepStrictEqual(Array.from(h.min), [21, 22])
+  assert.deepStrictEqual(Array.from(h.max), [23, 22])
+  assert.deepStrictEqual(Array.from(h.avg), [22, 22])
+  assert.deepStrictEqual(Array.from(h.last), [23, 22])
+  // only the last 4 samples are kept
+  sample(24, 2200)
+  sample(25, 2300)
+  assert.deepStrictEqual(Array.from(zwave.queryHistory(vid, 1000, 3000, 1000).count), [1, 3])
+  // (ts - from) rounds up to exactly (to - from) here: still the last bucket
+  sample(26, Math.pow(2, 53) - 1)
+  h = zwave.queryHistory(vid, -0.5, Math.pow(2, 53), Math.pow(2, 53))
+  assert.strictEqual(h.count.length, 1)
+  assert.strictEqual(h.count[0], 4)
+  assert.strictEqual(h.last[0], 26)
+  assert.throws(function () { zwave.queryHistory(vid, 1000, 1000, 100) }, RangeError)
+  assert.throws(function () { zwave.queryHistory(vid, 0, 1e9, 1) }, RangeError)
+  zwave.recordHistory(vid, { capacity: 0 })
+})
+
+check('meter timestamps', function () {
+  var energy = { class_id: 50, instance: 1, index: 0, type: 'decimal', value: 100, precision: 1, units: 'kWh' }
+  var power = { class_id: 50, instance: 1, index: 8, type: 'decimal', value: 5, precision: 1, units: 'W' }
+  function reading(value, ts) {
+    zwave._injectNotification(Notif.ValueChanged, 20, Object.assign({}, energy, { value: value }), ts)
+  }
+  zwave.trackMeters(true)
+  zwave._injectNotification(Notif.NodeAdded, 20)
+  zwave._injectNotification(Notif.ValueAdded, 20, energy, 1000)
+  zwave._injectNotification(Notif.ValueAdded, 20, power, 1000)
+  reading(100.5, 2000)
+  reading(101, 3000)
+  // a counter reset
+  reading(0.5, 4000)
+  var m = zwave.getMeterSummary(false)['20-50-1-0']
+  // timed by when the readings were reported, not when they got handled
+  assert.strictEqual(m.since, 1000)
+  assert.strictEqual(m.timestamp, 4000)
+  assert.strictEqual(m.value, 0.5)
+  assert.strictEqual(m.delta, 1.5)
+  assert.strictEqual(m.resets, 1)
+  assert.strictEqual(m.samples, 3)
+  assert(!('20-50-1-8' in zwave.getMeterSummary(false)))
+  zwave.trackMeters(false)
+  assert(!('20-50-1-0' in zwave.getMeterSummary()))
+  // the readings at hand are seeded as of when tracking starts
+  var before = Date.now()
+  zwave.trackMeters(true)
+  m = zwave.getMeterSummary()['20-50-1-0']
+  assert(m.timestamp >= before && m.timestamp <= Date.now())
+  assert.strictEqual(m.samples, 0)
+  zwave.trackMeters(false)
+})
+
+check('value table contents', function () {
+  var power = { class_id: 49, instance: 1, index: 4, type: 'int', value: 250 }
+  var vid = { node_id: 22, class_id: 49, instance: 1, index: 4 }
+  addValue(22, power)
+  zwave._injectNotification(Notif.ValueAdded, 22, { class_id: 114, instance: 1, index: 0, type: 'string', value: 'x' })
+  var table = zwave.enableValueTable(64)
+  var h = zwave.resolveValue(vid)
+  var slot = Array.prototype.indexOf.call(table.handles, h)
+  // the values known so far got their slots, only the numeric ones
+  assert.notStrictEqual(slot, -1)
+  assert.strictEqual(table.values[slot], 250)
+  assert.strictEqual(Array.prototype.indexOf.call(table.handles,
+    zwave.resolveValue({ node_id: 22, class_id: 114, instance: 1, index: 0 })), -1)
+  var gen = table.generations[slot]
+  zwave._injectNotification(Notif.ValueChanged, 22, Object.assign({}, power, { value: 260 }))
+  assert.strictEqual(table.values[slot], 260)
+  assert.strictEqual(table.generations[slot], gen + 1)
+  // a removed value frees its slot, for the next one added
+  zwave._injectNotification(Notif.ValueRemoved, 22, power)
+  assert.strictEqual(table.handles[slot], 0)
+  assert(isNaN(table.values[slot]))
+  zwave._injectNotification(Notif.ValueAdded, 22, { class_id: 49, instance: 1, index: 5, type: 'short', value: -3 })
+  var h2 = zwave.resolveValue({ node_id: 22, class_id: 49, instance: 1, index: 5 })
+  assert.strictEqual(table.handles[slot], h2)
+  assert.strictEqual(table.values[slot], -3)
+  zwave.disableValueTable()
+  zwave._injectNotification(Notif.ValueChanged, 22, { class_id: 49, instance: 1, index: 5, type: 'short', value: 7 })
+  // left with its last contents
+  assert.strictEqual(table.values[slot], -3)
+})
+
+check('handles of a node added again', function () {
+  var level = { class_id: 38, instance: 1, index: 0, type: 'byte', value: 10 }
+  var vid = { node_id: 23, class_id: 38, instance: 1, index: 0 }
+  addValue(23, level)
+  var nh = zwave.resolveNode(23)
+  var vh = zwave.resolveValue(vid)
+  assert.strictEqual(nh & 0xFF, 23)
+  zwave._injectNotification(Notif.NodeRemoved, 23)
+  assert.strictEqual(zwave.resolveNode(23), undefined)
+  assert.strictEqual(zwave.getNodeInfoByHandle(nh), undefined)
+  assert.throws(function () { zwave.getValueByHandle(vh) }, TypeError)
+  // same node id, new generation: the old handles stay dead
+  addValue(23, Object.assign({}, level, { value: 20 }))
+  var nh2 = zwave.resolveNode(23)
+  var vh2 = zwave.resolveValue(vid)
+  assert.strictEqual(nh2 & 0xFF, 23)
+  assert.notStrictEqual(nh2, nh)
+  assert.notStrictEqual(vh2, vh)
+  assert.strictEqual(zwave.getNodeInfoByHandle(nh), undefined)
+  assert.throws(function () { zwave.getValueByHandle(vh) }, TypeError)
+  assert.strictEqual(zwave.getValueByHandle(vh2), 20)
+})
+
+checkAsync('throttled value events', function (done) {
+  var level = { class_id: 38, instance: 1, index: 0, type: 'byte', value: 1, label: 'Level', units: '%', polled: 1 }
+  var vid = { node_id: 18, class_id: 38, instance: 1, index: 0 }
+  addValue(18, level)
+  assert.throws(function () { zwave.throttle(vid, -1) }, RangeError)
+  assert.throws(function () { zwave.throttle(vid, NaN) }, RangeError)
+  assert.throws(function () { zwave.throttle(vid, 4294967296) }, RangeError)
+  zwave.throttle(vid, 50)
+  var events = []
+  function listener(nodeid, comclass, value) {
+    events.push(value)
+  }
+  zwave.on('value changed', listener)
+  ;[2, 3, 4].forEach(function (value) {
+    zwave._injectNotification(Notif.ValueChanged, 18, Object.assign({}, level, { value: value }))
+  })
+  // the first one right away, the rest held back
+  assert.strictEqual(events.length, 1)
+  assert.strictEqual(events[0].value, 2)
+  // the native state follows regardless
+  assert.strictEqual(zwave.getValue(vid), 4)
+  // polling turned off meanwhile, as the trailing event will tell
+  zwave._injectNotification(Notif.PollingDisabled, 18, level)
+  setTimeout(function () {
+    zwave.removeListener('value changed', listener)
+    try {
+      // the final state at the end of the window, shaped like the direct one
+      assert.strictEqual(events.length, 2)
+      assert.strictEqual(events[1].value, 4)
+      assert.deepStrictEqual(Object.keys(events[1]).sort(), Object.keys(events[0]).sort())
+      assert.strictEqual(events[1].label, 'Level')
+      assert.strictEqual(events[1].units, '%')
+      assert.strictEqual(events[0].is_polled, true)
+      assert.strictEqual(events[1].is_polled, false)
+      zwave.throttle(vid, 0)
+      done()
+    } catch (e) {
+      done(e)
+    }
+  }, 200)
+})
+
+checkAsync('node liveness', function (done) {
+  var now = Date.now()
+  var Code = { Awake: 3, Sleep: 4, Dead: 5, Alive: 6 }
+  var Liveness = { Unknown: 0, Alive: 1, Awake: 2, Asleep: 3, Dead: 4 }
+  zwave._injectNotification(Notif.NodeAdded, 21, {}, now - 60000)
+  var l = zwave.getLiveness()
+  assert.strictEqual(l.status[21], Liveness.Unknown)
+  assert.strictEqual(l.lastSeen[21], 0)
+  zwave._injectNotification(Notif.NodeEvent, 21, { event: 255 }, now - 30000)
+  zwave._injectNotification(Notif.Notification, 21, { notification: Code.Sleep }, now - 20000)
+  l = zwave.getLiveness()
+  assert.strictEqual(l.status[21], Liveness.Asleep)
+  assert.strictEqual(l.lastSeen[21], now - 20000)
+  // dead isn't hearing from it
+  zwave._injectNotification(Notif.Notification, 21, { notification: Code.Dead }, now - 10000)
+  l = zwave.getLiveness()
+  assert.strictEqual(l.status[21], Liveness.Dead)
+  assert.strictEqual(l.lastSeen[21], now - 20000)
+  // an older notification handled late doesn't move it back
+  zwave._injectNotification(Notif.Notification, 21, { notification: Code.Alive }, now - 40000)
+  l = zwave.getLiveness()
+  assert.strictEqual(l.status[21], Liveness.Alive)
+  assert.strictEqual(l.lastSeen[21], now - 20000)
+  zwave.on('node silent', function silent(nodeid, lastSeen) {
+    if (nodeid !== 21) {
+      return
+    }
+    zwave.removeListener('node silent', silent)
+    zwave.setSilenceThreshold(0)
+    try {
+      assert.strictEqual(lastSeen, now - 20000)
+      done()
+    } catch (e) {
+      done(e)
+    }
+  })
+  // silent for 20 seconds already, reported on the first check
+  zwave.setSilenceThreshold(10)
+})
+
+runAsyncChecks(function () {
+  if (failed) {
+    console.log(failed + ' check(s) failed')
+    process.exit(1)
+  }
+  console.log('all native state checks passed')
+  process.exit()
+})
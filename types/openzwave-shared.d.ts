@@ -104,6 +104,68 @@ declare module "openzwave-shared" {
 			Invalid = 255,
 		}
 
+		export enum ValueFields {
+			Id = 1,
+			Metadata = 2,
+			Value = 4,
+			Items = 8,
+			All = 15,
+		}
+
+		export enum NodeFields {
+			Names = 1,
+			Protocol = 2,
+			Type = 4,
+			Status = 8,
+			All = 15,
+		}
+
+		export enum NodeLiveness {
+			Unknown = 0,
+			Alive = 1,
+			Awake = 2,
+			Asleep = 3,
+			Dead = 4,
+		}
+
+		export interface Liveness {
+			/** by node id, see NodeLiveness */
+			status: Uint8Array;
+			/** by node id, msec since the epoch, 0 if never */
+			lastSeen: Float64Array;
+		}
+
+		/**
+		 * A node as returned by getNodeInfo() / getNodes(). The properties
+		 * present depend on the NodeFields mask.
+		 */
+		export interface NodeDetails extends Partial<NodeInfo> {
+			node_id: number;
+			listening?: boolean;
+			frequent_listening?: boolean;
+			beaming?: boolean;
+			routing?: boolean;
+			security_device?: boolean;
+			max_baud_rate?: number;
+			version?: number;
+			security?: number;
+			basic?: number;
+			generic?: number;
+			specific?: number;
+			device_type?: number;
+			device_type_string?: string;
+			role?: number;
+			role_string?: string;
+			plus_type?: number;
+			plus_type_string?: string;
+			failed?: boolean;
+			awake?: boolean;
+			info_received?: boolean;
+			query_stage?: string;
+			polled?: boolean;
+			stale?: boolean;
+		}
+
 		export interface DriverStats {
 			SOFCnt: number;
 			ACKWaiting: number;
@@ -161,7 +223,142 @@ declare module "openzwave-shared" {
 			max: number;
 			is_polled: boolean;
 			values?: string[];
+			selected_index?: number;
+			precision?: number;
 			value: T;
+			/**
+			 * Set while the value is only known from the warm start file
+			 */
+			stale?: boolean;
+		}
+
+		export interface Deadband {
+			absolute?: number;
+			relative?: number;
+		}
+
+		export interface ThrottleOptions {
+			leading?: boolean;
+			trailing?: boolean;
+		}
+
+		export interface DeadbandStats {
+			suppressed: number;
+			values: { [value_id: string]: number };
+		}
+
+		export interface HistoryOptions {
+			capacity?: number;
+		}
+
+		export interface HistoryQuery {
+			timestamps: Float64Array;
+			min: Float64Array;
+			max: Float64Array;
+			avg: Float64Array;
+			last: Float64Array;
+			count: Float64Array;
+		}
+
+		export interface MeterOptions {
+			suppressEvents?: boolean;
+		}
+
+		export interface MeterStats {
+			value: number;
+			timestamp: number;
+			since: number;
+			delta: number;
+			rate: number;
+			resets: number;
+			samples: number;
+			totalDelta: number;
+			totalResets: number;
+			totalSamples: number;
+		}
+
+		export interface StringTableStats {
+			strings: number;
+			references: number;
+			bytes: number;
+			bytesSaved: number;
+		}
+
+		export type NodeStage = "added" | "protocolInfo" | "essentialQueriesComplete" | "queriesComplete";
+
+		export interface NodeStartupProfile {
+			node_id: number;
+			added?: number;
+			protocolInfo?: number;
+			essentialQueriesComplete?: number;
+			queriesComplete?: number;
+			durations: { [stage in NodeStage]?: number };
+			slowestStage: NodeStage;
+			slowestMsec: number;
+			total: number;
+			complete: boolean;
+		}
+
+		export type NodeMetaData = { node_id: number } & { [field in keyof typeof MetaDataFields]?: string };
+
+		export interface MemoryUsage {
+			count: number;
+			bytes: number;
+		}
+
+		export interface NotificationAllocations {
+			allocated: number;
+			freed: number;
+			live: number;
+			rate: number;
+		}
+
+		export interface MemoryStats {
+			nodes: MemoryUsage & { allocated: number, freed: number, retired: number };
+			values: MemoryUsage;
+			cachedValues: MemoryUsage;
+			valueHandles: MemoryUsage;
+			throttles: MemoryUsage;
+			histories: MemoryUsage;
+			meters: MemoryUsage;
+			queue: MemoryUsage;
+			scenes: MemoryUsage;
+			commandMap: MemoryUsage;
+			strings: MemoryUsage;
+			valueTable: MemoryUsage;
+			persistentHandles: number;
+			notifications: { [type: string]: NotificationAllocations };
+		}
+
+		export interface StartupProfile {
+			driver: {
+				connect?: number;
+				driverReady?: number;
+				awakeNodesQueried?: number;
+				allNodesQueried?: number;
+				elapsed?: number;
+			};
+			nodes: NodeStartupProfile[];
+		}
+
+		export interface Snapshot {
+			seq: number;
+			getNodeIds(): number[];
+			getValues(nodeId?: number): Value[];
+			toJSON(): { seq: number, values: Value[] };
+		}
+
+		export interface ValueChanges {
+			seq: number;
+			reset: boolean;
+			values: Value[];
+			removed: string[];
+		}
+
+		export interface ValueTable {
+			values: Float64Array;
+			handles: Uint32Array;
+			generations: Uint32Array;
 		}
 
 		export interface SwitchPoint {
@@ -313,6 +510,15 @@ declare module "openzwave-shared" {
 			 * Should we include the Instance Label in Value Labels on MultiInstance Devices
 			 */
 			IncludeInstanceLabel: boolean;
+			/**
+			 * Emit Decimal values as numbers (along with their precision) instead of strings
+			 */
+			DecimalAsNumber: boolean;
+			/**
+			 * Seconds between saves of the node and value state to the warm start
+			 * file in the UserPath, which is loaded back on connect. 0 (default) to disable
+			 */
+			WarmStartInterval: number;
 		}
 	}
 
@@ -351,6 +557,8 @@ declare module "openzwave-shared" {
 			listener: (nodeId: number, notification: ZWave.Notification, help: string) => void,
 		): this;
 		on(event: "scan complete", listener: () => void): this;
+		on(event: "node silent", listener: (nodeId: number, lastSeen: number) => void): this;
+		on(event: "cached snapshot", listener: (snapshot: ZWave.Snapshot, savedAt: number) => void): this;
 		on(
 			event: "controller command",
 			listener: (
@@ -633,6 +841,12 @@ declare module "openzwave-shared" {
 		 */
 		getNodeClassInformation(nodeId: number, commClass: number): number;
 
+		/**
+		 * Gets all the Command Classes supported by a node, with their names and
+		 * versions, in one call. Undefined for unknown nodes.
+		 */
+		getNodeCommandClasses(nodeId: number): Array<{ class_id: number, name: string, version: number }> | undefined;
+
 		/**
 		 * LEGACY MODE (using setNodeOn)
 		 * @deprecated
@@ -733,8 +947,38 @@ declare module "openzwave-shared" {
 
 		getMetaData(nodeId: number, metadata: ZWave.MetaDataFields): string;
 
+		/**
+		 * Get all the device database metadata of a node in one call (undefined
+		 * for unknown nodes), or of all known nodes without a node id.
+		 */
+		getAllMetaData(nodeId: number): ZWave.NodeMetaData | undefined;
+		getAllMetaData(): ZWave.NodeMetaData[];
+
 		getChangeLog(nodeId: number, revision: number): ZWave.ChangeLogEntry;
 
+		/**
+		 * Get everything known about a node in one call, undefined for
+		 * unknown nodes. The fields mask (see ZWave.NodeFields) selects
+		 * which properties are filled in.
+		 */
+		getNodeInfo(nodeId: number, fields?: ZWave.NodeFields): ZWave.NodeDetails | undefined;
+
+		/**
+		 * Resolve a node id into an opaque handle to the node as it is now,
+		 * which stops resolving once the node is removed or re-included.
+		 */
+		resolveNode(nodeId: number): number | undefined;
+
+		/**
+		 * As getNodeInfo(), by node handle. Undefined for stale handles.
+		 */
+		getNodeInfoByHandle(handle: number, fields?: ZWave.NodeFields): ZWave.NodeDetails | undefined;
+
+		/**
+		 * Get all known nodes in one call, as in getNodeInfo().
+		 */
+		getNodes(fields?: ZWave.NodeFields): ZWave.NodeDetails[];
+
 		// Exposed by "openzwave-values.cc"
 
 		/**
@@ -754,6 +998,174 @@ declare module "openzwave-shared" {
 		 */
 		refreshValue(valueId: ZWave.ValueId): boolean;
 
+		/**
+		 * Resolve a ValueID into an opaque integer handle, for use with the xxxByHandle calls.
+		 */
+		resolveValue(valueId: ZWave.ValueId): number;
+		resolveValue(nodeid: number, class_id: number, instance: number, index: number): number;
+
+		/**
+		 * Same as setValue, using a handle returned by resolveValue.
+		 */
+		setValueByHandle(handle: number, value: string | boolean | number): void;
+
+		/**
+		 * Same as refreshValue, using a handle returned by resolveValue.
+		 */
+		refreshValueByHandle(handle: number): boolean;
+
+		/**
+		 * Get all the values of a node in one call. The optional fields mask
+		 * (see ZWave.ValueFields) selects which properties are filled in.
+		 */
+		getValues(nodeId: number, fields?: ZWave.ValueFields): ZWave.Value[];
+
+		/**
+		 * Get the values of all known nodes in one call.
+		 */
+		getAllValues(fields?: ZWave.ValueFields): ZWave.Value[];
+
+		/**
+		 * Get the items of a List value. 'value changed' events only carry
+		 * the selected item (value) and its position (selected_index).
+		 */
+		getValueListItems(valueId: ZWave.ValueId): string[];
+		getValueListItems(nodeid: number, class_id: number, instance: number, index: number): string[];
+
+		/**
+		 * Get the last known contents of a value, as kept from the notifications.
+		 * Doesn't call into OpenZWave; undefined if not reported yet.
+		 */
+		getValue(valueId: ZWave.ValueId): boolean | number | string | Buffer | undefined;
+		getValue(nodeid: number, class_id: number, instance: number, index: number): boolean | number | string | Buffer | undefined;
+		getValueByHandle(handle: number): boolean | number | string | Buffer | undefined;
+
+		/**
+		 * Get any value in its string form, eg. Decimals when the DecimalAsNumber option is set.
+		 */
+		getValueAsString(valueId: ZWave.ValueId): string;
+		getValueAsString(nodeid: number, class_id: number, instance: number, index: number): string;
+
+		// Exposed by "openzwave-filters.cc"
+
+		/**
+		 * Drop change events of a numeric value within a deadband around the
+		 * last emitted value. Pass null to remove it.
+		 */
+		setDeadband(valueId: ZWave.ValueId, deadband: ZWave.Deadband | null): void;
+		setDeadband(nodeid: number, class_id: number, instance: number, index: number, deadband: ZWave.Deadband | null): void;
+
+		/**
+		 * Get the number of change events suppressed by deadbands.
+		 */
+		getDeadbandStats(): ZWave.DeadbandStats;
+
+		/**
+		 * Emit at most one change event of a value, or node event of a node,
+		 * per window of msec, at most 4294967295. A window of 0 removes the throttle.
+		 */
+		throttle(valueId: ZWave.ValueId, msec: number, options?: ZWave.ThrottleOptions): void;
+		throttle(nodeId: number, msec: number, options?: ZWave.ThrottleOptions): void;
+
+		// Exposed by "openzwave-history.cc"
+
+		/**
+		 * Keep the last 'capacity' samples (default 1440, at most 1048576) of
+		 * a numeric value. A capacity of 0 stops recording.
+		 */
+		recordHistory(valueId: ZWave.ValueId, options?: ZWave.HistoryOptions): void;
+		recordHistory(nodeid: number, class_id: number, instance: number, index: number, options?: ZWave.HistoryOptions): void;
+
+		/**
+		 * Aggregate the recorded samples of a value taken between from and to
+		 * (msec since the epoch) in buckets of bucketMsec, at most 65536 of them.
+		 */
+		queryHistory(valueId: ZWave.ValueId, from: number, to: number, bucketMsec: number): ZWave.HistoryQuery;
+		queryHistory(nodeid: number, class_id: number, instance: number, index: number, from: number, to: number, bucketMsec: number): ZWave.HistoryQuery;
+
+		// Exposed by "openzwave-meters.cc"
+
+		/**
+		 * Start or stop accumulating the readings of Meter command class values
+		 * that count up (energy, volume, pulses).
+		 */
+		trackMeters(enable: boolean, options?: ZWave.MeterOptions): void;
+
+		/**
+		 * Get the accumulated readings of all tracked meters, keyed by value_id.
+		 * Starts a new window, unless reset is false.
+		 */
+		getMeterSummary(reset?: boolean): { [value_id: string]: ZWave.MeterStats };
+
+		// Exposed by "openzwave-strings.cc"
+
+		/**
+		 * Get the size of the shared table of value metadata strings,
+		 * and the bytes saved by it.
+		 */
+		getStringTableStats(): ZWave.StringTableStats;
+
+		// Exposed by "openzwave-profile.cc"
+
+		/**
+		 * Get the startup timeline of the driver and of each node's interview,
+		 * nodes ordered by total interview time, slowest first.
+		 */
+		getStartupProfile(): ZWave.StartupProfile;
+
+		// Exposed by "openzwave-memory.cc"
+
+		/**
+		 * Get the counts and approximate bytes of the addon's own native state,
+		 * and the notification allocations per notification type.
+		 */
+		getMemoryStats(): ZWave.MemoryStats;
+
+		// Exposed by "openzwave-liveness.cc"
+
+		/**
+		 * Get the status and last-seen time of all nodes, indexed by node id.
+		 */
+		getLiveness(): ZWave.Liveness;
+
+		/**
+		 * Emit 'node silent' once a node hasn't been heard from for this many
+		 * seconds, at most 4294967. 0 (the default) disables it.
+		 */
+		setSilenceThreshold(seconds: number): void;
+
+		// Exposed by "openzwave-snapshot.cc"
+
+		/**
+		 * Take an immutable, point-in-time snapshot of all nodes and values.
+		 * Copies an entry per value (sharing the contents), so it's linear
+		 * in the number of values.
+		 */
+		snapshot(): ZWave.Snapshot;
+
+		// Exposed by "openzwave-changes.cc"
+
+		/**
+		 * Get the values added/changed after sequence number seq, and the
+		 * value_ids of those removed. Pass the returned seq on the next call.
+		 */
+		changesSince(seq: number, fields?: ZWave.ValueFields): ZWave.ValueChanges;
+
+		// Exposed by "openzwave-valuetable.cc"
+
+		/**
+		 * Keep a network-wide table of all numeric values, updated in place
+		 * as they change. Slot i holds the value of handles[i] (0 if empty),
+		 * generations[i] is bumped on every update of that slot. The capacity
+		 * defaults to 1024, anything outside 1..1048575 throws a RangeError.
+		 */
+		enableValueTable(capacity?: number): ZWave.ValueTable;
+
+		/**
+		 * Stop updating the value table.
+		 */
+		disableValueTable(): void;
+
 		/**
 		 * Ask OZW to verify the value change before notifying the application.
 		 */